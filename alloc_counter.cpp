@@ -0,0 +1,82 @@
+#include "alloc_counter.h"
+
+#if defined(ROBOTDH_ALLOC_COUNTER)
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> gAllocs{0};
+
+void* countedAlloc(std::size_t size) {
+  gAllocs.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t al) {
+  gAllocs.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t a = static_cast<std::size_t>(al);
+#if defined(_MSC_VER)
+  return _aligned_malloc(size ? size : 1, a);
+#else
+  // aligned_alloc требует размер, кратный выравниванию
+  const std::size_t rounded = ((size ? size : 1) + a - 1) / a * a;
+  return std::aligned_alloc(a, rounded);
+#endif
+}
+
+void alignedFree(void* p) {
+#if defined(_MSC_VER)
+  _aligned_free(p);
+#else
+  std::free(p);
+#endif
+}
+} // namespace
+
+// ---- Подмена глобальных operator new/delete ----
+void* operator new(std::size_t size) {
+  if (void* p = countedAlloc(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+  if (void* p = countedAlloc(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t al) {
+  if (void* p = countedAlignedAlloc(size, al)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+  if (void* p = countedAlignedAlloc(size, al)) return p;
+  throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept   { return countedAlignedAlloc(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, al); }
+
+void operator delete(void* p) noexcept                                  { std::free(p); }
+void operator delete[](void* p) noexcept                                { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                     { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept           { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept         { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept                { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+bool AllocCounter::enabled() { return true; }
+std::uint64_t AllocCounter::count() { return gAllocs.load(std::memory_order_relaxed); }
+
+#else
+
+bool AllocCounter::enabled() { return false; }
+std::uint64_t AllocCounter::count() { return 0; }
+
+#endif
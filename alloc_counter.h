@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+// Отладочный счётчик кучи: сколько раз вызывался глобальный operator new.
+// Реализация (alloc_counter.cpp) не входит в robotdh_core: исполняемый файл подключает
+// объект CMake-цели robotdh_alloc_counter (robotdh_bench — всегда, robotdh_cli и Robot —
+// с опцией ROBOTDH_ALLOC_COUNTER). Собранный без макроса ROBOTDH_ALLOC_COUNTER файл
+// operator new не подменяет, и count() всегда 0.
+//
+//   AllocCounter::Scope scope;
+//   core.computeForwardKinematics(out);
+//   assert(scope.allocations() == 0);
+namespace AllocCounter {
+
+// Собран ли счётчик в этой сборке
+bool enabled();
+
+// Число вызовов operator new (всех видов) с начала процесса
+std::uint64_t count();
+
+// Сколько аллокаций произошло с момента создания объекта
+class Scope {
+public:
+  Scope() : start_(count()) {}
+  std::uint64_t allocations() const { return count() - start_; }
+
+private:
+  std::uint64_t start_;
+};
+
+} // namespace AllocCounter
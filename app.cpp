@@ -1,6 +1,17 @@
 #include "app.h"
 #include "presets.h"
+#include "trajectory_file.h"
 #include <QMessageBox>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+App::App(Core& core, Visual& visual, QObject* parent)
+  : QObject(parent), core_(core), visual_(visual) {
+  playTimer_.setTimerType(Qt::PreciseTimer);
+  playTimer_.setInterval(1000 / 60);
+  connect(&playTimer_, &QTimer::timeout, this, &App::onPlaybackTick);
+}
 
 void App::showStartupTable(QTableWidget* table) const {
   // дефолтная длина (внутренний kDof из пресета)
@@ -14,6 +25,7 @@ void App::showStartupTable(QTableWidget* table, size_t dof) const {
 
 void App::onCalculateClicked(QTableWidget* table, QLCDNumber* xLcd, QLCDNumber* yLcd, QLCDNumber* zLcd) {
   if (!table) return;
+  pausePlayback();
 
   // 1) Снять ввод из таблицы
   const Snapshot snap = visual_.readTable(table);
@@ -69,6 +81,8 @@ void App::onInsertRowBelow(QTableWidget* table, int row) {
 void App::onClearClicked(QTableWidget* table) {
   if (!table) return;
 
+  pausePlayback();
+
   // Одна строка нулей
   Snapshot s;
   s.push_back(JointDH{0.0, 0.0, 0.0, 0.0});
@@ -84,6 +98,69 @@ void App::onClearClicked(QTableWidget* table) {
 void App::onDefaultClicked(QTableWidget* table) {
   if (!table) return;
 
+  pausePlayback();
+
   // Таблица как при старте (внутренний kDof из пресетов)
   visual_.drawTable(table, Presets::Default());
 }
+
+/*===========================  ВОСПРОИЗВЕДЕНИЕ  ===========================*/
+
+bool App::loadTrajectory(const QString& path, double sampleRate, QTableWidget* table) {
+  pausePlayback();
+
+  Trajectory::Reader reader;
+  std::string error;
+  if (!reader.open(path.toStdString(), &error) || !player_.load(reader, sampleRate, &error)) {
+    QMessageBox::warning(table, QStringLiteral("Траектория"),
+                         QStringLiteral("Не удалось загрузить траекторию: ") + QString::fromStdString(error));
+    return false;
+  }
+
+  if (table) visual_.drawTable(table, reader.chain());
+  playTimer_.start();   // первый кадр — выборка 0
+  return true;
+}
+
+void App::onPlayPauseClicked() {
+  if (!player_.loaded()) return;
+  if (player_.playing()) player_.pause();
+  else                   player_.play();
+  playTimer_.start();
+  emit playbackStateChanged(player_.playing());
+}
+
+void App::onScrub(int sample) {
+  if (!player_.loaded()) return;
+  player_.seek(sample);
+  playTimer_.start();
+}
+
+void App::onSpeedChanged(double speed) { player_.setSpeed(speed); }
+
+void App::onFrameRateChanged(int hz) {
+  playTimer_.setInterval(std::max(1, int(std::lround(1000.0 / std::max(1, hz)))));
+}
+
+void App::onLoopToggled(bool loop) { player_.setLoop(loop); }
+
+void App::onPlaybackTick() {
+  // Поток GUI не ждёт FK: берём последний готовый кадр, если он есть. Не успевающие кадры
+  // пропускаются (позиция идёт по часам), между выборками — интерполяция углов
+  const bool wasPlaying = player_.playing();
+  if (player_.tick(playFrame_)) {
+    visual_.swapComputed(playFrame_);   // без копии: прежний кадр Visual вернётся плееру буфером
+    emit playbackFrameShown(int(std::lround(player_.shownPosition())));
+  }
+  if (wasPlaying && !player_.playing()) emit playbackStateChanged(false);   // дошли до конца
+
+  // Пауза и нужный кадр уже показан — таймер не нужен до следующей команды
+  if (!player_.playing() && !player_.pending()) playTimer_.stop();
+}
+
+void App::pausePlayback() {
+  playTimer_.stop();
+  if (!player_.playing()) return;
+  player_.pause();
+  emit playbackStateChanged(false);
+}
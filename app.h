@@ -1,20 +1,27 @@
 #pragma once
 #include <QObject>
 #include <QTableWidget>
+#include <QTimer>
 #include "core.h"
+#include "trajectory_player.h"
 #include "visual.h"
 
 // Сервис уровня приложения: сценарии и координация слоёв.
 class App : public QObject {
   Q_OBJECT
 public:
-  App(Core& core, Visual& visual, QObject* parent = nullptr)
-    : QObject(parent), core_(core), visual_(visual) {}
+  App(Core& core, Visual& visual, QObject* parent = nullptr);
 
   // Сценарий старта: показать дефолтную таблицу (любой длины)
   void showStartupTable(QTableWidget* table) const;            // дефолтная длина
   void showStartupTable(QTableWidget* table, size_t dof) const; // явная длина
 
+  // Воспроизведение траектории (*.rdht с углами суставов): цепь — в таблицу, кадр 0 — в 3D.
+  // FK считает фоновый поток TrajectoryPlayer, сюда по таймеру приходят готовые кадры.
+  // sampleRate — выборок траектории в секунду (в файле не хранится)
+  bool loadTrajectory(const QString& path, double sampleRate, QTableWidget* table);
+  size_t trajectorySamples() const { return player_.samples(); }
+
   // Сделаем таблицу явным параметром в слоте — это ещё сильнее развяжет App от UI
 public slots:
   // Нажали "Рассчитать":
@@ -39,7 +46,25 @@ public slots:
   //По умолчанию: как при запуске (Presets::Default())
   void onDefaultClicked(QTableWidget* table);
 
+  // Воспроизведение
+  void onPlayPauseClicked();
+  void onScrub(int sample);             // перемотка на выборку
+  void onSpeedChanged(double speed);    // множитель времени
+  void onFrameRateChanged(int hz);      // целевая частота кадров 3D (60–240)
+  void onLoopToggled(bool loop);
+
+signals:
+  void playbackFrameShown(int sample);      // кадр траектории ушёл в 3D (для ползунка и LCD)
+  void playbackStateChanged(bool playing);
+
 private:
+  void onPlaybackTick();
+  void pausePlayback();                     // ручной расчёт/очистка перебивают воспроизведение
+
   Core& core_;
   Visual& visual_;
+
+  TrajectoryPlayer player_;
+  QTimer playTimer_;                        // тики кадров; в простое остановлен
+  Results playFrame_;                       // буфер, которым App меняется с TrajectoryPlayer и Visual
 };
@@ -0,0 +1,88 @@
+// gui.* замеры robotdh_bench: сквозной путь кнопки "Рассчитать" на offscreen-сцене.
+// Собирается только с GUI (ROBOTDH_BUILD_GUI), см. robotdh_bench.cpp.
+
+#include "bench_harness.h"
+#include "app.h"
+#include "core.h"
+#include "presets.h"
+#include "visual.h"
+
+#include <QApplication>
+#include <QFrame>
+#include <QLCDNumber>
+#include <QTableWidget>
+
+#include <vector>
+
+namespace {
+
+Snapshot makeChain(size_t dof) {
+  Snapshot s(dof);
+  for (size_t i = 0; i < dof; ++i) s[i] = Presets::kTZ6[i % Presets::kTZ6Dof];
+  return s;
+}
+
+// Отложенные события Qt (deleteLater и т.п.) — часть стоимости кадра
+void flushDeferred() {
+  QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+} // namespace
+
+void runGuiBenchmarks(Bench::Runner& run, int argc, char** argv, const std::vector<size_t>& dofs) {
+  if (!run.selected("gui.")) return;
+
+  // Без дисплея: окно Qt3D создаётся, но на экран не выводится
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+  QApplication app(argc, argv);
+
+  QFrame frame;
+  frame.resize(800, 600);
+  QTableWidget table;
+  QLCDNumber xLcd, yLcd, zLcd;
+
+  Core core;
+  Visual visual;
+  visual.init3D(&frame);
+  App service(core, visual);
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    visual.drawTable(&table, chain);
+    flushDeferred();
+
+    run.measure("gui.readTable", dof, 1.0, [&] {
+      const Snapshot s = visual.readTable(&table);
+      Bench::keep(s.back());
+    });
+
+    Results results;
+    core.setInput(chain);
+    core.computeForwardKinematics(results);
+    run.measure("gui.render.setData", dof, 1.0, [&] {
+      visual.setComputed(results);
+      flushDeferred();
+    });
+
+    // Новая поза на каждом вызове: меняется theta первого сустава, то есть все кадры
+    Snapshot moved = chain;
+    moved[0].theta_deg += 10.0;
+    Results other;
+    core.setInput(moved);
+    core.computeForwardKinematics(other);
+    bool swap = false;
+    run.measure("gui.render.setData.moved", dof, 1.0, [&] {
+      visual.setComputed((swap = !swap) ? other : results);
+      flushDeferred();
+    });
+
+    // Правка theta первого сустава -> "Рассчитать": readTable -> FK -> setData -> LCD
+    QTableWidgetItem* theta0 = table.item(0, 0);
+    bool flip = false;
+    run.measure("gui.e2e.calculate", dof, 1.0, [&] {
+      theta0->setText((flip = !flip) ? "10.000" : "20.000");
+      service.onCalculateClicked(&table, &xLcd, &yLcd, &zLcd);
+      flushDeferred();
+    });
+  }
+}
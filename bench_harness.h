@@ -0,0 +1,151 @@
+#pragma once
+#include "alloc_counter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Минимальный замерщик для robotdh_bench: без внешних зависимостей, вывод — JSON.
+//
+//   Bench::Runner run(cfg);
+//   run.measure("core.makeA", 0, 1, [&] { ... одна операция ... });
+//   run.writeJson(stdout, "sse2");
+//
+// Число итераций подбирается так, чтобы замер шёл не меньше cfg.minTimeSec.
+// ns/op и allocs/op — на одну операцию (один вызов тела), configs/s —
+// конфигураций цепи в секунду (для пакетных тел одна операция = много конфигураций).
+namespace Bench {
+
+// Не дать компилятору выбросить результат тела
+template <class T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+struct Result {
+  std::string name;
+  size_t   dof = 0;           // 0 — не зависит от длины цепи
+  uint64_t iterations = 0;
+  double   nsPerOp = 0.0;
+  double   allocsPerOp = 0.0;
+  double   configsPerSec = 0.0;
+};
+
+// Проверка точности: максимум ошибки по выборке против допуска
+struct Check {
+  std::string name;
+  size_t dof = 0;
+  double maxError = 0.0;
+  double bound = 0.0;
+  bool passed() const { return maxError <= bound; }
+};
+
+struct Config {
+  double minTimeSec = 0.2;    // время одного замера
+  std::string filter;         // пусто — все; иначе подстрока имени
+};
+
+class Runner {
+public:
+  explicit Runner(Config cfg) : cfg_(std::move(cfg)) {}
+
+  bool selected(const std::string& name) const {
+    return cfg_.filter.empty() || name.find(cfg_.filter) != std::string::npos;
+  }
+
+  // body() — одна операция; configsPerOp — сколько конфигураций она считает
+  template <class Body>
+  void measure(const std::string& name, size_t dof, double configsPerOp, Body&& body) {
+    if (!selected(name)) return;
+    using Clock = std::chrono::steady_clock;
+
+    body();  // прогрев: кэши, ленивые буферы
+
+    // Калибровка: удваиваем число итераций, пока прогон не займёт ~1/10 бюджета
+    uint64_t iters = 1;
+    double elapsed = 0.0;
+    for (;;) {
+      const auto t0 = Clock::now();
+      for (uint64_t i = 0; i < iters; ++i) body();
+      elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+      if (elapsed >= cfg_.minTimeSec / 10.0 || iters >= (uint64_t(1) << 40)) break;
+      iters *= 2;
+    }
+    if (elapsed > 0.0 && elapsed < cfg_.minTimeSec)
+      iters = std::max<uint64_t>(1, uint64_t(double(iters) * cfg_.minTimeSec / elapsed));
+
+    // Замер
+    AllocCounter::Scope allocs;
+    const auto t0 = Clock::now();
+    for (uint64_t i = 0; i < iters; ++i) body();
+    elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+    const uint64_t nAllocs = allocs.allocations();
+
+    Result r;
+    r.name = name;
+    r.dof = dof;
+    r.iterations = iters;
+    r.nsPerOp = elapsed * 1e9 / double(iters);
+    r.allocsPerOp = double(nAllocs) / double(iters);
+    r.configsPerSec = (elapsed > 0.0) ? configsPerOp * double(iters) / elapsed : 0.0;
+    results_.push_back(r);
+
+    std::fprintf(stderr, "%-28s dof=%-3zu %12.1f ns/op %8.2f allocs/op %14.0f configs/s\n",
+                 name.c_str(), dof, r.nsPerOp, r.allocsPerOp, r.configsPerSec);
+  }
+
+  const std::vector<Result>& results() const { return results_; }
+
+  void check(const std::string& name, size_t dof, double maxError, double bound) {
+    if (!selected(name)) return;
+    checks_.push_back(Check{ name, dof, maxError, bound });
+    std::fprintf(stderr, "%-28s dof=%-3zu max error %.3g (bound %.3g) %s\n",
+                 name.c_str(), dof, maxError, bound, checks_.back().passed() ? "ok" : "FAILED");
+  }
+
+  bool allChecksPassed() const {
+    for (const Check& c : checks_) if (!c.passed()) return false;
+    return true;
+  }
+
+  // {"isa": ..., "alloc_counter": ..., "results": [ {...}, ... ], "checks": [ {...}, ... ]}
+  void writeJson(std::FILE* out, const char* isa) const {
+    std::fprintf(out, "{\n  \"schema\": 1,\n  \"isa\": \"%s\",\n  \"alloc_counter\": %s,\n"
+                      "  \"min_time_s\": %g,\n  \"results\": [\n",
+                 isa, AllocCounter::enabled() ? "true" : "false", cfg_.minTimeSec);
+    for (size_t i = 0; i < results_.size(); ++i) {
+      const Result& r = results_[i];
+      std::fprintf(out, "    {\"name\": \"%s\", \"dof\": %zu, \"iterations\": %llu, "
+                        "\"ns_per_op\": %.3f, ",
+                   r.name.c_str(), r.dof, static_cast<unsigned long long>(r.iterations), r.nsPerOp);
+      if (AllocCounter::enabled()) std::fprintf(out, "\"allocs_per_op\": %.4f, ", r.allocsPerOp);
+      else                         std::fprintf(out, "\"allocs_per_op\": null, ");
+      std::fprintf(out, "\"configs_per_s\": %.1f}%s\n",
+                   r.configsPerSec, (i + 1 < results_.size()) ? "," : "");
+    }
+    std::fprintf(out, "  ],\n  \"checks\": [\n");
+    for (size_t i = 0; i < checks_.size(); ++i) {
+      const Check& c = checks_[i];
+      std::fprintf(out, "    {\"name\": \"%s\", \"dof\": %zu, \"max_error\": %.6g, "
+                        "\"bound\": %.6g, \"passed\": %s}%s\n",
+                   c.name.c_str(), c.dof, c.maxError, c.bound, c.passed() ? "true" : "false",
+                   (i + 1 < checks_.size()) ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+  }
+
+private:
+  Config cfg_;
+  std::vector<Result> results_;
+  std::vector<Check> checks_;
+};
+
+} // namespace Bench
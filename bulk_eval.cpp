@@ -0,0 +1,48 @@
+#include "bulk_eval.h"
+
+namespace Bulk {
+
+void forwardKinematics(ThreadPool& pool, const CompiledChain& chain,
+                       const double* thetas_deg, size_t samples, Results& out,
+                       Core::BatchOutput mode, size_t grain) {
+  out.clear();
+  const size_t dof = chain.dof();
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  const bool tcpOnly = (mode == Core::BatchOutput::TcpOnly);
+  out.resize(tcpOnly ? samples : samples * dof);
+  Interp* dst = out.data();
+
+  pool.parallelFor(samples, grain, [&](size_t begin, size_t end, int) {
+    for (size_t i = begin; i < end; ++i) {
+      const double* th = thetas_deg + i * dof;
+      if (tcpOnly) dst[i] = chain.computeTcp(th);
+      else         chain.compute(th, dst + i * dof);
+    }
+  });
+}
+
+void jacobians(ThreadPool& pool, const JacobianEngine& engine,
+               const double* thetas_deg, size_t samples,
+               std::vector<double>& J, Results* tcp, size_t grain) {
+  const size_t dof = engine.dof();
+  J.resize(samples * dof * 6);
+  if (tcp) tcp->resize(dof ? samples : 0);
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  // Кадры одной выборки — свой буфер у каждого исполнителя
+  std::vector<Results> scratch(static_cast<size_t>(pool.slots()), Results(dof));
+  double* dstJ = J.data();
+  Interp* dstTcp = tcp ? tcp->data() : nullptr;
+
+  pool.parallelFor(samples, grain, [&](size_t begin, size_t end, int worker) {
+    Interp* frames = scratch[static_cast<size_t>(worker)].data();
+    for (size_t i = begin; i < end; ++i) {
+      engine.chain().compute(thetas_deg + i * dof, frames);
+      JacobianEngine::fromFrames(frames, dof, dof - 1, dstJ + i * dof * 6);
+      if (dstTcp) dstTcp[i] = frames[dof - 1];
+    }
+  });
+}
+
+} // namespace Bulk
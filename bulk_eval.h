@@ -0,0 +1,28 @@
+#pragma once
+#include "compiled_chain.h"
+#include "jacobian.h"
+#include "thread_pool.h"
+#include <vector>
+
+// Пакетные расчёты по траекториям поверх ThreadPool.
+// Core хранит состояние (input_, кэш) и между потоками не делится, поэтому здесь —
+// только неизменяемые CompiledChain/JacobianEngine: их const-методы потокобезопасны.
+// Результаты пишутся по индексу выборки — порядок не зависит от числа потоков.
+namespace Bulk {
+
+// Кусок по умолчанию: сколько конфигураций берёт исполнитель за раз
+constexpr size_t kDefaultGrain = 1024;
+
+// FK по N x dof углам; раскладка выхода как у Core::computeForwardKinematicsBatch
+void forwardKinematics(ThreadPool& pool, const CompiledChain& chain,
+                       const double* thetas_deg, size_t samples, Results& out,
+                       Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                       size_t grain = kDefaultGrain);
+
+// Якобианы TCP по N x dof углам; раскладка как у JacobianEngine::computeBatch
+void jacobians(ThreadPool& pool, const JacobianEngine& engine,
+               const double* thetas_deg, size_t samples,
+               std::vector<double>& J, Results* tcp = nullptr,
+               size_t grain = kDefaultGrain);
+
+} // namespace Bulk
@@ -0,0 +1,307 @@
+#include "collision.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Collision {
+
+namespace {
+
+inline double dot(const double* a, const double* b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+
+// Единичный вектор (как QVector3D::normalized: нулевой остаётся нулевым)
+inline void unit(double x, double y, double z, double* out) {
+  const double n = std::sqrt(x*x + y*y + z*z);
+  const double k = (n > 1e-12) ? 1.0 / n : 0.0;
+  out[0] = x * k; out[1] = y * k; out[2] = z * k;
+}
+
+// Проекция v на единичный dir со знаком (Render3D::signedProjLen)
+inline double signedProj(const double* v, const double* dir) { return dot(v, dir); }
+
+// Расстояние между AABB (0 — пересекаются)
+inline double boxDistance(const double* alo, const double* ahi, const double* blo, const double* bhi) {
+  double s = 0.0;
+  for (int k = 0; k < 3; ++k) {
+    const double g = std::max(blo[k] - ahi[k], alo[k] - bhi[k]);
+    if (g > 0.0) s += g * g;
+  }
+  return std::sqrt(s);
+}
+
+} // namespace
+
+double tubeRadius(const Interp* frames, size_t n) {
+  double maxR = 1.0;
+  for (size_t i = 0; i < n; ++i) {
+    const Interp& r = frames[i];
+    maxR = std::max(maxR, std::sqrt(r.x*r.x + r.y*r.y + r.z*r.z));
+  }
+  return std::max(0.009, maxR * 0.018) * 2.0;
+}
+
+void buildCapsules(const Interp* frames, size_t n, double radius, std::vector<Capsule>& out) {
+  out.clear();
+  if (n == 0) return;
+
+  int group = -1, lastBody = -1;
+  auto add = [&](const double* a, const double* dir, double len, int body) {
+    if (body != lastBody) { ++group; lastBody = body; }
+    Capsule c;
+    for (int k = 0; k < 3; ++k) { c.a[k] = a[k]; c.b[k] = a[k] + dir[k] * len; }
+    c.r = radius;
+    c.body = body;
+    c.group = group;
+    out.push_back(c);
+  };
+
+  const double origin[3] = { 0.0, 0.0, 0.0 };
+  const double zBase[3]  = { 0.0, 0.0, 1.0 };
+
+  // База: по Z до проекции p_0
+  {
+    const double p0[3] = { frames[0].x, frames[0].y, frames[0].z };
+    const double proj = signedProj(p0, zBase);
+    const double dir[3] = { 0.0, 0.0, (proj >= 0.0) ? 1.0 : -1.0 };
+    if (std::fabs(proj) > 1e-6) add(origin, dir, std::fabs(proj), 0);
+  }
+
+  const size_t last = n - 1;   // TCP: Z-трубку не строим
+  for (size_t i = 0; i <= last; ++i) {
+    const Interp& f = frames[i];
+    const double p[3] = { f.x, f.y, f.z };
+    double ex[3], ez[3];
+    unit(f.xx, f.xy, f.xz, ex);
+    unit(f.zx, f.zy, f.zz, ez);
+
+    // X_i: от проекции p_i на Z_{i-1} (для i = 0 — на базовую Z через начало координат)
+    const double* pPrev = origin;
+    double zPrev[3] = { zBase[0], zBase[1], zBase[2] };
+    double prevPos[3];
+    if (i > 0) {
+      const Interp& g = frames[i - 1];
+      prevPos[0] = g.x; prevPos[1] = g.y; prevPos[2] = g.z;
+      pPrev = prevPos;
+      unit(g.zx, g.zy, g.zz, zPrev);
+    }
+    const double d[3] = { p[0] - pPrev[0], p[1] - pPrev[1], p[2] - pPrev[2] };
+    const double t = dot(d, zPrev);
+    const double s[3] = { pPrev[0] + zPrev[0] * t, pPrev[1] + zPrev[1] * t, pPrev[2] + zPrev[2] * t };
+    const double ps[3] = { p[0] - s[0], p[1] - s[1], p[2] - s[2] };
+    const double projX = signedProj(ps, ex);
+    if (std::fabs(projX) > 1e-5) {
+      const double dir[3] = { (projX >= 0.0) ? ex[0] : -ex[0],
+                              (projX >= 0.0) ? ex[1] : -ex[1],
+                              (projX >= 0.0) ? ex[2] : -ex[2] };
+      add(s, dir, std::fabs(projX), int(i) + 1);
+    }
+
+    // Z_i: от p_i на проекцию (p_{i+1} - p_i) на z_i
+    if (i < last) {
+      const Interp& h = frames[i + 1];
+      const double dp[3] = { h.x - p[0], h.y - p[1], h.z - p[2] };
+      const double projZ = signedProj(dp, ez);
+      if (std::fabs(projZ) > 1e-6) {
+        const double dir[3] = { (projZ >= 0.0) ? ez[0] : -ez[0],
+                                (projZ >= 0.0) ? ez[1] : -ez[1],
+                                (projZ >= 0.0) ? ez[2] : -ez[2] };
+        add(p, dir, std::fabs(projZ), int(i) + 1);
+      }
+    }
+  }
+}
+
+double segmentDistance(const double p0[3], const double p1[3], const double q0[3], const double q1[3]) {
+  // Ближайшие точки двух отрезков (Эриксон, "Real-Time Collision Detection", 5.1.9)
+  const double d1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+  const double d2[3] = { q1[0] - q0[0], q1[1] - q0[1], q1[2] - q0[2] };
+  const double r[3]  = { p0[0] - q0[0], p0[1] - q0[1], p0[2] - q0[2] };
+  const double a = dot(d1, d1), e = dot(d2, d2), f = dot(d2, r);
+  constexpr double eps = 1e-18;
+
+  double s = 0.0, t = 0.0;
+  if (a <= eps && e <= eps) {
+    // обе — точки
+  } else if (a <= eps) {
+    t = std::clamp(f / e, 0.0, 1.0);
+  } else {
+    const double c = dot(d1, r);
+    if (e <= eps) {
+      s = std::clamp(-c / a, 0.0, 1.0);
+    } else {
+      const double b = dot(d1, d2);
+      const double denom = a * e - b * b;
+      s = (denom > eps * a * e) ? std::clamp((b * f - c * e) / denom, 0.0, 1.0) : 0.0;
+      t = (b * s + f) / e;
+      if (t < 0.0)      { t = 0.0; s = std::clamp(-c / a, 0.0, 1.0); }
+      else if (t > 1.0) { t = 1.0; s = std::clamp((b - c) / a, 0.0, 1.0); }
+    }
+  }
+
+  double dd = 0.0;
+  for (int k = 0; k < 3; ++k) {
+    const double v = (p0[k] + d1[k] * s) - (q0[k] + d2[k] * t);
+    dd += v * v;
+  }
+  return std::sqrt(dd);
+}
+
+// ---- Checker ----
+
+Result Checker::query(const Interp* frames, size_t n) { return run(frames, n, false); }
+
+bool Checker::collides(const Interp* frames, size_t n) { return run(frames, n, true).collides; }
+
+Result Checker::run(const Interp* frames, size_t n, bool stopAtFirst) {
+  const double radius = (opt_.radius > 0.0) ? opt_.radius : tubeRadius(frames, n);
+  buildCapsules(frames, n, radius, caps_);
+  nodes_.clear();
+
+  best_ = Result{};
+  cutoff_ = stopAtFirst ? opt_.margin : std::numeric_limits<double>::infinity();
+  stopAtFirst_ = stopAtFirst;
+  done_ = false;
+
+  if (caps_.size() >= 2) {
+    nodes_.reserve(2 * caps_.size());
+    self(buildNode(0, int(caps_.size())));
+  }
+  best_.collides = best_.distance < opt_.margin;
+  return best_;
+}
+
+int Checker::buildNode(int first, int count) {
+  const int id = int(nodes_.size());
+  nodes_.push_back(Node{});
+  Node nd{};
+  nd.first = first;
+  nd.count = count;
+  nd.left = nd.right = -1;
+
+  // Капсулы идут по цепи и соседние сцеплены концами, поэтому делим диапазон пополам
+  // без сортировки: у половины цепи рамка и так плотная. Лист — до 4 капсул
+  if (count > 4) {
+    const int half = count / 2;
+    nd.left  = buildNode(first, half);
+    nd.right = buildNode(first + half, count - half);
+    const Node& l = nodes_[size_t(nd.left)];
+    const Node& r = nodes_[size_t(nd.right)];
+    for (int k = 0; k < 3; ++k) {
+      nd.lo[k] = std::min(l.lo[k], r.lo[k]);
+      nd.hi[k] = std::max(l.hi[k], r.hi[k]);
+    }
+    nd.rmax = std::max(l.rmax, r.rmax);
+  } else {
+    const Capsule& c0 = caps_[size_t(first)];
+    for (int k = 0; k < 3; ++k) { nd.lo[k] = nd.hi[k] = c0.a[k]; }
+    for (int i = first; i < first + count; ++i) {
+      const Capsule& c = caps_[size_t(i)];
+      for (int k = 0; k < 3; ++k) {
+        nd.lo[k] = std::min(nd.lo[k], std::min(c.a[k], c.b[k]));
+        nd.hi[k] = std::max(nd.hi[k], std::max(c.a[k], c.b[k]));
+      }
+      nd.rmax = std::max(nd.rmax, c.r);
+    }
+  }
+  nodes_[size_t(id)] = nd;
+  return id;
+}
+
+void Checker::self(int node) {
+  if (done_) return;
+  const Node& nd = nodes_[size_t(node)];
+  if (nd.left < 0) {
+    for (int i = nd.first; i < nd.first + nd.count; ++i)
+      for (int j = i + 1; j < nd.first + nd.count; ++j) test(i, j);
+    return;
+  }
+  const int l = nd.left, r = nd.right;
+  self(l);
+  self(r);
+  pair(l, r);
+}
+
+void Checker::pair(int a, int b) {
+  if (done_) return;
+  const Node& na = nodes_[size_t(a)];
+  const Node& nb = nodes_[size_t(b)];
+
+  // Все пары — соседние тела (группы по цепи не убывают): проверять нечего
+  const int gLo = std::min(caps_[size_t(na.first)].group, caps_[size_t(nb.first)].group);
+  const int gHi = std::max(caps_[size_t(na.first + na.count - 1)].group,
+                           caps_[size_t(nb.first + nb.count - 1)].group);
+  if (gHi - gLo <= opt_.adjacentSkip) return;
+
+  // Нижняя оценка зазора любой пары из этих узлов
+  const double bound = boxDistance(na.lo, na.hi, nb.lo, nb.hi) - na.rmax - nb.rmax;
+  if (bound >= cutoff_) return;
+
+  if (na.left < 0 && nb.left < 0) {
+    for (int i = na.first; i < na.first + na.count; ++i)
+      for (int j = nb.first; j < nb.first + nb.count; ++j) test(i, j);
+    return;
+  }
+  // Спускаемся в больший узел (или в тот, что не лист)
+  const bool splitA = nb.left < 0 || (na.left >= 0 && na.count >= nb.count);
+  if (splitA) { const int l = na.left, r = na.right; pair(l, b); pair(r, b); }
+  else        { const int l = nb.left, r = nb.right; pair(a, l); pair(a, r); }
+}
+
+void Checker::test(int i, int j) {
+  if (done_) return;
+  const Capsule& ci = caps_[size_t(i)];
+  const Capsule& cj = caps_[size_t(j)];
+  if (std::abs(ci.group - cj.group) <= opt_.adjacentSkip) return;
+
+  // Дешёвое отсечение по AABB осей, до точного расстояния между отрезками
+  double gap = 0.0;
+  for (int k = 0; k < 3; ++k) {
+    const double g = std::max(std::min(cj.a[k], cj.b[k]) - std::max(ci.a[k], ci.b[k]),
+                              std::min(ci.a[k], ci.b[k]) - std::max(cj.a[k], cj.b[k]));
+    if (g > 0.0) gap += g * g;
+  }
+  const double reach = cutoff_ + ci.r + cj.r;
+  if (reach <= 0.0 || gap >= reach * reach) return;
+
+  const double d = segmentDistance(ci.a, ci.b, cj.a, cj.b) - ci.r - cj.r;
+  if (d >= cutoff_) return;
+
+  cutoff_ = d;
+  best_.distance = d;
+  best_.capsuleA = std::min(i, j);
+  best_.capsuleB = std::max(i, j);
+  best_.bodyA = caps_[size_t(best_.capsuleA)].body;
+  best_.bodyB = caps_[size_t(best_.capsuleB)].body;
+  if (stopAtFirst_) done_ = true;
+}
+
+// ---- Пакеты ----
+
+void checkBatch(ThreadPool* pool, const Interp* frames, size_t samples, size_t dof,
+                const Options& opt, std::vector<Result>& out, size_t grain) {
+  out.assign(samples, Result{});
+  if (dof == 0 || samples == 0 || !frames) return;
+  Result* dst = out.data();
+
+  if (!pool) {
+    Checker checker(opt);
+    for (size_t i = 0; i < samples; ++i) dst[i] = checker.query(frames + i * dof, dof);
+    return;
+  }
+
+  // Свой Checker (буферы капсул и BVH) у каждого исполнителя
+  std::vector<Checker> checkers(static_cast<size_t>(pool->slots()), Checker(opt));
+  pool->parallelFor(samples, grain, [&](size_t begin, size_t end, int worker) {
+    Checker& checker = checkers[static_cast<size_t>(worker)];
+    for (size_t i = begin; i < end; ++i) dst[i] = checker.query(frames + i * dof, dof);
+  });
+}
+
+size_t firstCollision(const Interp* frames, size_t samples, size_t dof, const Options& opt) {
+  if (dof == 0 || !frames) return samples;
+  Checker checker(opt);
+  for (size_t i = 0; i < samples; ++i)
+    if (checker.collides(frames + i * dof, dof)) return i;
+  return samples;
+}
+
+} // namespace Collision
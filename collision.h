@@ -0,0 +1,106 @@
+#pragma once
+#include "initaldate.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Самопересечение цепи по капсулам звеньев (без Qt, на готовых кадрах FK).
+//
+// Геометрия — отрезки трубок Render3D::buildJointAxes. Радиус по умолчанию — tubeRadius ниже;
+// им же Render3D::updateStyle задаёт толщину трубок, так что капсулы совпадают с картинкой.
+//   база:  от (0,0,0) по базовой Z до проекции p_0 на неё (Render3D::buildBaseAxes);
+//   X_i:   от проекции p_i на ось Z_{i-1} (для i = 0 — на базовую Z) вдоль ±x_i, если длина > 1e-5;
+//   Z_i:   от p_i вдоль ±z_i на проекцию (p_{i+1} - p_i) на z_i, если длина > 1e-6 (кроме TCP).
+// Трубка с полусферами на концах — капсула. X_i и Z_i жёстко связаны с кадром i (тело i+1),
+// база — тело 0. Соседние тела сходятся в суставе и касаются всегда, поэтому пары тел,
+// отстоящих не дальше Options::adjacentSkip (тела без капсул не считаются), не проверяются.
+//
+// Расстояние — между поверхностями капсул: |отрезок - отрезок| - rA - rB, < 0 — проникновение.
+// Поиск ближайшей пары — по BVH из AABB капсул с отсечением узлов по текущему минимуму.
+// Капсулы идут вдоль цепи, поэтому дерево строится делением диапазона пополам без сортировки,
+// а пары узлов, где все тела соседние, отбрасываются целиком.
+namespace Collision {
+
+struct Capsule {
+  double a[3], b[3];   // ось капсулы, метры
+  double r;            // радиус, метры
+  int body;            // 0 — база, i+1 — кадр i
+  int group;           // порядковый номер тела среди тел, у которых есть капсулы
+};
+
+struct Options {
+  double radius = 0.0;     // радиус капсул, м; 0 — как в 3D-виде (tubeRadius по позе)
+  int adjacentSkip = 1;    // не проверять пары с |groupA - groupB| <= adjacentSkip
+  double margin = 0.0;     // требуемый зазор: столкновение, если distance < margin
+};
+
+struct Result {
+  double distance = std::numeric_limits<double>::infinity();  // мин. зазор; inf — пар нет
+  int capsuleA = -1, capsuleB = -1;   // индексы в capsules()
+  int bodyA = -1, bodyB = -1;
+  bool collides = false;              // distance < margin
+};
+
+// Радиус трубок для этой позы — общий для капсул и Render3D::updateStyle
+double tubeRadius(const Interp* frames, size_t n);
+
+// Капсулы позы (n кадров цепи) с радиусом radius
+void buildCapsules(const Interp* frames, size_t n, double radius, std::vector<Capsule>& out);
+
+// Расстояние между отрезками p0-p1 и q0-q1
+double segmentDistance(const double p0[3], const double p1[3], const double q0[3], const double q1[3]);
+
+// Запросы для одной позы. Буферы (капсулы, BVH) переиспользуются между вызовами, поэтому
+// объект — на поток: для пакетов см. checkBatch.
+class Checker {
+public:
+  explicit Checker(const Options& opt = Options{}) : opt_(opt) {}
+
+  const Options& options() const { return opt_; }
+
+  // Ближайшая проверяемая пара и зазор
+  Result query(const Interp* frames, size_t n);
+  Result query(const Results& frames) { return query(frames.data(), frames.size()); }
+
+  // Только да/нет: обход останавливается на первой паре ближе margin
+  bool collides(const Interp* frames, size_t n);
+  bool collides(const Results& frames) { return collides(frames.data(), frames.size()); }
+
+  // Капсулы последнего запроса
+  const std::vector<Capsule>& capsules() const { return caps_; }
+
+private:
+  struct Node {
+    double lo[3], hi[3];   // AABB осей капсул (без радиуса)
+    double rmax;
+    int left, right;       // -1 — лист
+    int first, count;      // капсулы caps_[first .. first+count)
+  };
+
+  Result run(const Interp* frames, size_t n, bool stopAtFirst);
+  int buildNode(int first, int count);
+  void self(int node);
+  void pair(int a, int b);
+  void test(int i, int j);
+
+  Options opt_;
+  std::vector<Capsule> caps_;
+  std::vector<Node> nodes_;
+
+  // Состояние текущего обхода
+  Result best_;
+  double cutoff_ = 0.0;
+  bool stopAtFirst_ = false;
+  bool done_ = false;
+};
+
+// Пакет: frames — раскладка AllFrames пакетной FK (samples x dof кадров), out — по выборке.
+// pool == nullptr — в вызывающем потоке
+void checkBatch(ThreadPool* pool, const Interp* frames, size_t samples, size_t dof,
+                const Options& opt, std::vector<Result>& out, size_t grain = 256);
+
+// Первая выборка траектории со столкновением (samples — если таких нет)
+size_t firstCollision(const Interp* frames, size_t samples, size_t dof, const Options& opt);
+
+} // namespace Collision
@@ -0,0 +1,198 @@
+#include "compiled_chain.h"
+#include <cmath>
+
+namespace {
+constexpr double DEG2RAD = 3.14159265358979323846 / 180.0;
+
+// Разворот по нулевым a/d для фиксированного вида alpha
+template <FixedDH::AlphaKind K>
+inline void stepSparse(FixedDH::Affine& C, double ct, double st,
+                       double ca, double sa, double a, double d) {
+  if (a == 0.0) {
+    if (d == 0.0) FixedDH::step<K, false, false>(C, ct, st, ca, sa, a, d);
+    else          FixedDH::step<K, false, true >(C, ct, st, ca, sa, a, d);
+  } else {
+    if (d == 0.0) FixedDH::step<K, true,  false>(C, ct, st, ca, sa, a, d);
+    else          FixedDH::step<K, true,  true >(C, ct, st, ca, sa, a, d);
+  }
+}
+} // namespace
+
+void CompiledChain::compile(const Snapshot& s, Backend backend) {
+  backend_ = backend;
+  links_.clear();
+  thetas_.clear();
+  links_.reserve(s.size());
+  thetas_.reserve(s.size());
+
+  for (const auto& j : s) {
+    links_.push_back(Link{
+      FixedDH::classifyAlpha(j.alpha_rad),
+      std::cos(j.alpha_rad), std::sin(j.alpha_rad),
+      std::cos(0.5 * j.alpha_rad), std::sin(0.5 * j.alpha_rad),
+      j.a_m, j.d_m
+    });
+    thetas_.push_back(j.theta_deg);
+  }
+}
+
+void CompiledChain::apply(const Link& L, double ct, double st, FixedDH::Affine& C) {
+  // Ветка одна и та же для данного звена на всех выборках — предсказывается идеально
+  switch (L.kind) {
+    case FixedDH::AlphaKind::Zero:
+      stepSparse<FixedDH::AlphaKind::Zero>(C, ct, st, L.ca, L.sa, L.a, L.d); break;
+    case FixedDH::AlphaKind::PlusHalfPi:
+      stepSparse<FixedDH::AlphaKind::PlusHalfPi>(C, ct, st, L.ca, L.sa, L.a, L.d); break;
+    case FixedDH::AlphaKind::MinusHalfPi:
+      stepSparse<FixedDH::AlphaKind::MinusHalfPi>(C, ct, st, L.ca, L.sa, L.a, L.d); break;
+    default:
+      stepSparse<FixedDH::AlphaKind::General>(C, ct, st, L.ca, L.sa, L.a, L.d); break;
+  }
+}
+
+void CompiledChain::apply(const Link& L, double theta_deg, QuatDH::Rigid& C) {
+  const double h = 0.5 * theta_deg * DEG2RAD;
+  QuatDH::step(C, std::cos(h), std::sin(h), L.cha, L.sha,
+               L.kind == FixedDH::AlphaKind::Zero, L.a, L.d);
+}
+
+Results CompiledChain::computeForwardKinematics() const {
+  Results out;
+  computeForwardKinematics(out);
+  return out;
+}
+
+void CompiledChain::computeForwardKinematics(Results& out) const {
+  compute(thetas_.data(), out);
+}
+
+void CompiledChain::compute(const double* theta_deg, Results& out) const {
+  out.resize(links_.size());
+  compute(theta_deg, out.data());
+}
+
+void CompiledChain::compute(const double* theta_deg, Interp* out) const {
+  if (backend_ == Backend::Quaternion) {
+    QuatDH::Rigid Q = QuatDH::identity();
+    for (size_t k = 0; k < links_.size(); ++k) {
+      apply(links_[k], theta_deg[k], Q);
+      out[k] = QuatDH::interpret(Q);
+    }
+    return;
+  }
+
+  FixedDH::Affine C = FixedDH::identityAffine();
+  for (size_t k = 0; k < links_.size(); ++k) {
+    const double t = theta_deg[k] * DEG2RAD;
+    apply(links_[k], std::cos(t), std::sin(t), C);
+    out[k] = FixedDH::interpret(C);
+  }
+}
+
+Interp CompiledChain::computeTcp(const double* theta_deg) const {
+  if (backend_ == Backend::Quaternion) {
+    QuatDH::Rigid Q = QuatDH::identity();
+    for (size_t k = 0; k < links_.size(); ++k) apply(links_[k], theta_deg[k], Q);
+    return QuatDH::interpret(Q);
+  }
+
+  FixedDH::Affine C = FixedDH::identityAffine();
+  for (size_t k = 0; k < links_.size(); ++k) {
+    const double t = theta_deg[k] * DEG2RAD;
+    apply(links_[k], std::cos(t), std::sin(t), C);
+  }
+  return FixedDH::interpret(C);
+}
+
+void CompiledChain::computeBatch(const double* thetas_deg, size_t samples, Results& out,
+                                 Core::BatchOutput mode) const {
+  out.clear();
+  const size_t dof = links_.size();
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  if (mode == Core::BatchOutput::TcpOnly) {
+    out.resize(samples);
+    for (size_t i = 0; i < samples; ++i) out[i] = computeTcp(thetas_deg + i * dof);
+  } else {
+    out.resize(samples * dof);
+    for (size_t i = 0; i < samples; ++i) compute(thetas_deg + i * dof, out.data() + i * dof);
+  }
+}
+
+// ---- Позы ----
+
+void CompiledChain::computePoses(const double* theta_deg, Pose* out, size_t reorthoEvery) const {
+  if (backend_ == Backend::Quaternion) {
+    QuatDH::Rigid Q = QuatDH::identity();
+    for (size_t k = 0; k < links_.size(); ++k) {
+      apply(links_[k], theta_deg[k], Q);
+      if (reorthoEvery && (k + 1) % reorthoEvery == 0) QuatDH::renormalize(Q);
+      out[k] = QuatDH::toPose(Q);
+    }
+    return;
+  }
+
+  FixedDH::Affine C = FixedDH::identityAffine();
+  for (size_t k = 0; k < links_.size(); ++k) {
+    const double t = theta_deg[k] * DEG2RAD;
+    apply(links_[k], std::cos(t), std::sin(t), C);
+    if (reorthoEvery && (k + 1) % reorthoEvery == 0) FixedDH::reorthonormalize(C);
+    out[k] = PoseMath::fromAffine(C);
+  }
+}
+
+Pose CompiledChain::computeTcpPose(const double* theta_deg, size_t reorthoEvery) const {
+  if (backend_ == Backend::Quaternion) {
+    QuatDH::Rigid Q = QuatDH::identity();
+    for (size_t k = 0; k < links_.size(); ++k) {
+      apply(links_[k], theta_deg[k], Q);
+      if (reorthoEvery && (k + 1) % reorthoEvery == 0) QuatDH::renormalize(Q);
+    }
+    return QuatDH::toPose(Q);
+  }
+
+  FixedDH::Affine C = FixedDH::identityAffine();
+  for (size_t k = 0; k < links_.size(); ++k) {
+    const double t = theta_deg[k] * DEG2RAD;
+    apply(links_[k], std::cos(t), std::sin(t), C);
+    if (reorthoEvery && (k + 1) % reorthoEvery == 0) FixedDH::reorthonormalize(C);
+  }
+  return PoseMath::fromAffine(C);
+}
+
+void CompiledChain::computeBatchPoses(const double* thetas_deg, size_t samples, Poses& out,
+                                      Core::BatchOutput mode, size_t reorthoEvery) const {
+  out.clear();
+  const size_t dof = links_.size();
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  if (mode == Core::BatchOutput::TcpOnly) {
+    out.resize(samples);
+    for (size_t i = 0; i < samples; ++i) out[i] = computeTcpPose(thetas_deg + i * dof, reorthoEvery);
+  } else {
+    out.resize(samples * dof);
+    for (size_t i = 0; i < samples; ++i)
+      computePoses(thetas_deg + i * dof, out.data() + i * dof, reorthoEvery);
+  }
+}
+
+void CompiledChain::computeBatchPoses(const double* thetas_deg, size_t samples, PosesF& out,
+                                      Core::BatchOutput mode, size_t reorthoEvery) const {
+  out.clear();
+  const size_t dof = links_.size();
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  if (mode == Core::BatchOutput::TcpOnly) {
+    out.resize(samples);
+    for (size_t i = 0; i < samples; ++i)
+      out[i] = PoseMath::toFloat(computeTcpPose(thetas_deg + i * dof, reorthoEvery));
+  } else {
+    // Кадры одной выборки считаются в double во временный буфер, пишутся во float
+    out.resize(samples * dof);
+    Poses frames(dof);
+    for (size_t i = 0; i < samples; ++i) {
+      computePoses(thetas_deg + i * dof, frames.data(), reorthoEvery);
+      for (size_t k = 0; k < dof; ++k) out[i * dof + k] = PoseMath::toFloat(frames[k]);
+    }
+  }
+}
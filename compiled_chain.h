@@ -0,0 +1,75 @@
+#pragma once
+#include "core.h"
+#include "fixed_chain.h"
+#include "pose.h"
+#include "quat_chain.h"
+#include <vector>
+
+// "Скомпилированная" цепь: строится один раз из Snapshot, дальше на каждое звено
+// нужны только cos/sin(theta). Постоянные звена (cos/sin(alpha), a, d) посчитаны заранее,
+// T0->i хранится как аффинная 3x4 (нижняя строка [0 0 0 1] не умножается), а для частых
+// alpha (0, ±pi/2) и нулевых a/d используется разреженный вариант шага (FixedDH::step).
+// Выход — те же Results, что у Core, поэтому цепь подменяет Core без изменений у потребителей.
+// Объект после compile() не меняется — один экземпляр можно читать из нескольких потоков.
+class CompiledChain {
+public:
+  // Чем переносится T0->i по цепи (интерфейс и выход одни и те же):
+  //   Matrix     — аффинная 3x4 (FixedDH::step), кадры ортонормируются как в Core::interpretOne;
+  //   Quaternion — кватернион + перенос (quat_chain.h): меньше умножений на звено,
+  //                оси кадра без Грама-Шмидта. Расхождение с Matrix ~ dof * 1e-16 * вылет цепи
+  //                (2e-15 на 6 звеньях; проверка — robotdh_bench --check).
+  enum class Backend { Matrix, Quaternion };
+
+  CompiledChain() = default;
+  explicit CompiledChain(const Snapshot& s, Backend backend = Backend::Matrix) { compile(s, backend); }
+
+  // Собрать цепь: геометрия и углы по умолчанию берутся из s
+  void compile(const Snapshot& s, Backend backend = Backend::Matrix);
+
+  size_t dof() const { return links_.size(); }
+  Backend backend() const { return backend_; }
+
+  // Как Core::computeForwardKinematics: углы — из Snapshot, по которому собрана цепь
+  Results computeForwardKinematics() const;
+  void computeForwardKinematics(Results& out) const;
+
+  // Свои углы: theta_deg — dof значений в градусах
+  void compute(const double* theta_deg, Results& out) const;   // все кадры (out.size() = dof)
+  void compute(const double* theta_deg, Interp* out) const;    // все кадры в готовый массив из dof
+  Interp computeTcp(const double* theta_deg) const;            // только TCP
+
+  // Пакет: раскладка как у Core::computeForwardKinematicsBatch
+  void computeBatch(const double* thetas_deg, size_t samples, Results& out,
+                    Core::BatchOutput mode = Core::BatchOutput::AllFrames) const;
+
+  // ---- Компактный выход: позиция + кватернион (pose.h) ----
+  // Кадры не ортонормируются по одному: reorthoEvery > 0 — накопленный поворот приводится
+  // к ортонормированному (Quaternion: нормируется) каждые reorthoEvery звеньев, 0 — никогда
+  // (дрейф |q| ~ dof * 1e-16). Точную единичность даёт PoseMath::normalize по запросу.
+  void computePoses(const double* theta_deg, Pose* out, size_t reorthoEvery = 0) const;   // dof кадров
+  Pose computeTcpPose(const double* theta_deg, size_t reorthoEvery = 0) const;
+
+  // Пакет поз: раскладка как у computeBatch; PosesF — те же позы, записанные во float
+  void computeBatchPoses(const double* thetas_deg, size_t samples, Poses& out,
+                         Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                         size_t reorthoEvery = 0) const;
+  void computeBatchPoses(const double* thetas_deg, size_t samples, PosesF& out,
+                         Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                         size_t reorthoEvery = 0) const;
+
+private:
+  struct Link {
+    FixedDH::AlphaKind kind;
+    double ca, sa;     // cos/sin(alpha)
+    double cha, sha;   // cos/sin(alpha/2) — для Backend::Quaternion
+    double a, d;       // метры
+  };
+
+  // Один шаг C = C * A_i(theta) по заранее разобранному звену
+  static void apply(const Link& L, double ct, double st, FixedDH::Affine& C);
+  static void apply(const Link& L, double theta_deg, QuatDH::Rigid& C);
+
+  Backend backend_ = Backend::Matrix;
+  std::vector<Link> links_;
+  std::vector<double> thetas_;   // theta_deg из исходного Snapshot
+};
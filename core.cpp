@@ -1,19 +1,23 @@
 #include "core.h"
+#include "compiled_chain.h"
 #include <cmath>
 #include <algorithm>
+#include <type_traits>
 
 // ---- Вспомогательная математика ----
 
-void Core::identity(double T[4][4]) {
+template <class Scalar>
+void BasicCore<Scalar>::identity(Scalar T[4][4]) {
   for (int r = 0; r < 4; ++r)
     for (int c = 0; c < 4; ++c)
-      T[r][c] = (r == c) ? 1.0 : 0.0;
+      T[r][c] = (r == c) ? Scalar(1) : Scalar(0);
 }
 
-void Core::mul(const double L[4][4], const double R[4][4], double Out[4][4]) {
+template <class Scalar>
+void BasicCore<Scalar>::mul(const Scalar L[4][4], const Scalar R[4][4], Scalar Out[4][4]) {
   for (int r = 0; r < 4; ++r) {
     for (int c = 0; c < 4; ++c) {
-      double sum = 0.0;
+      Scalar sum = 0;
       for (int k = 0; k < 4; ++k) sum += L[r][k] * R[k][c];
       Out[r][c] = sum;
     }
@@ -21,59 +25,58 @@ void Core::mul(const double L[4][4], const double R[4][4], double Out[4][4]) {
 }
 
 // Классический DH: A = Rz(theta)*Tz(d)*Tx(a)*Rx(alpha)
-void Core::makeA(double theta_rad, double a_m, double d_m, double alpha_rad, double A[4][4]) {
-  const double ct = std::cos(theta_rad),  st = std::sin(theta_rad);
-  const double ca = std::cos(alpha_rad),  sa = std::sin(alpha_rad);
+template <class Scalar>
+void BasicCore<Scalar>::makeA(double theta_rad, double a_m, double d_m, double alpha_rad, Scalar A[4][4]) {
+  const Scalar t = Scalar(theta_rad), al = Scalar(alpha_rad);
+  const Scalar a = Scalar(a_m), d = Scalar(d_m);
+  const Scalar ct = std::cos(t),   st = std::sin(t);
+  const Scalar ca = std::cos(al),  sa = std::sin(al);
 
   // Стандартная форма
   // [ ct  -st*ca   st*sa   a*ct ]
   // [ st   ct*ca  -ct*sa   a*st ]
   // [  0     sa      ca      d  ]
   // [  0      0       0      1  ]
-  A[0][0] =  ct;   A[0][1] = -st*ca;  A[0][2] =  st*sa;  A[0][3] = a_m*ct;
-  A[1][0] =  st;   A[1][1] =  ct*ca;  A[1][2] = -ct*sa;  A[1][3] = a_m*st;
-  A[2][0] =  0.0;  A[2][1] =  sa;     A[2][2] =  ca;     A[2][3] = d_m;
-  A[3][0] =  0.0;  A[3][1] =  0.0;    A[3][2] =  0.0;    A[3][3] = 1.0;
+  A[0][0] =  ct;   A[0][1] = -st*ca;  A[0][2] =  st*sa;  A[0][3] = a*ct;
+  A[1][0] =  st;   A[1][1] =  ct*ca;  A[1][2] = -ct*sa;  A[1][3] = a*st;
+  A[2][0] =  0;    A[2][1] =  sa;     A[2][2] =  ca;     A[2][3] = d;
+  A[3][0] =  0;    A[3][1] =  0;      A[3][2] =  0;      A[3][3] = 1;
 }
 
-Snapshot Core::normalizeUnits(const Snapshot& s) {
-  Snapshot out;
-  out.reserve(s.size());
+template <class Scalar>
+void BasicCore<Scalar>::composeFrom(const Snapshot& s, size_t first, std::vector<Matrix>& transforms) {
   constexpr double DEG2RAD = 3.14159265358979323846 / 180.0;
-
-  for (const auto& j : s) {
-    // theta: deg -> rad; alpha: уже rad; a,d: метры
-    out.push_back(JointDH{
-      j.theta_deg * DEG2RAD,
-      j.a_m,
-      j.d_m,
-      j.alpha_rad
-    });
+  const size_t n = s.size();
+  transforms.resize(n);
+  if (first >= n) return;
+
+  Scalar cumulative[4][4];     // текущая накопленная T0->i
+  if (first == 0) {
+    identity(cumulative);
+  } else {
+    // стартуем с последней актуальной T0->(first-1)
+    const auto& prev = transforms[first - 1];
+    int idx = 0;
+    for (int r = 0; r < 4; ++r)
+      for (int c = 0; c < 4; ++c)
+        cumulative[r][c] = prev[idx++];
   }
-  return out;
-}
 
-void Core::composeAll(const Snapshot& s, std::vector<std::array<double,16>>& transforms) {
-  transforms.clear();
-  if (s.empty()) return;
-
-  double cumulative[4][4];     // текущая накопленная T0->i
-  identity(cumulative);
-
-  for (const auto& joint : s) {
-    double local[4][4];
-    makeA(joint.theta_deg, joint.a_m, joint.d_m, joint.alpha_rad, local);
+  for (size_t i = first; i < n; ++i) {
+    const auto& joint = s[i];
+    // theta: deg -> rad; alpha: уже rad; a,d: метры
+    Scalar local[4][4];
+    makeA(joint.theta_deg * DEG2RAD, joint.a_m, joint.d_m, joint.alpha_rad, local);
 
-    double next[4][4];
+    Scalar next[4][4];
     mul(cumulative, local, next);
 
     // сохранить как плоский массив
-    std::array<double,16> flat{};
+    auto& flat = transforms[i];
     int idx = 0;
     for (int r = 0; r < 4; ++r)
       for (int c = 0; c < 4; ++c)
         flat[idx++] = next[r][c];
-    transforms.push_back(flat);
 
     // шаг вперёд
     for (int r = 0; r < 4; ++r)
@@ -82,24 +85,31 @@ void Core::composeAll(const Snapshot& s, std::vector<std::array<double,16>>& tra
   }
 }
 
-Interp Core::interpretOne(const std::array<double,16>& M) {
+template <class Scalar>
+bool BasicCore<Scalar>::sameJoint(const JointDH& l, const JointDH& r) {
+  return l.theta_deg == r.theta_deg && l.a_m == r.a_m &&
+         l.d_m == r.d_m && l.alpha_rad == r.alpha_rad;
+}
+
+template <class Scalar>
+typename BasicCore<Scalar>::Frame BasicCore<Scalar>::interpretOne(const Matrix& M) {
   // Из 4x4 вытаскиваем положение и три столбца поворотной матрицы (X, Y, Z)
-  const auto at = [&](int r, int c)->double { return M[r*4 + c]; };
+  const auto at = [&](int r, int c)->Scalar { return M[r*4 + c]; };
 
   // Позиция
-  const double px = at(0,3), py = at(1,3), pz = at(2,3);
+  const Scalar px = at(0,3), py = at(1,3), pz = at(2,3);
 
   // Столбцы R: X = col0, Y = col1, Z = col2
   // Берём сырые значения
-  double xx = at(0,0), xy = at(1,0), xz = at(2,0);
-  double yx, yy, yz; // объявим, но пересчитаем ниже
-  double zx = at(0,2), zy = at(1,2), zz = at(2,2);
+  Scalar xx = at(0,0), xy = at(1,0), xz = at(2,0);
+  Scalar yx, yy, yz; // объявим, но пересчитаем ниже
+  Scalar zx = at(0,2), zy = at(1,2), zz = at(2,2);
 
   // --- Орто-нормировка на всякий случай (числовая устойчивость) ---
   // Нормируем Z
-  auto norm = [](double& a, double& b, double& c){
-    const double n = std::sqrt(a*a + b*b + c*c);
-    if (n > 1e-12) { a/=n; b/=n; c/=n; }
+  auto norm = [](Scalar& a, Scalar& b, Scalar& c){
+    const Scalar n = std::sqrt(a*a + b*b + c*c);
+    if (n > Scalar(1e-12)) { a/=n; b/=n; c/=n; }
   };
 
   // Z
@@ -107,7 +117,7 @@ Interp Core::interpretOne(const std::array<double,16>& M) {
 
   // Проецируем X на плоскость, ортогональную Z, затем нормируем
   // X = X - (X·Z) Z
-  const double x_dot_z = xx*zx + xy*zy + xz*zz;
+  const Scalar x_dot_z = xx*zx + xy*zy + xz*zz;
   xx -= x_dot_z * zx;  xy -= x_dot_z * zy;  xz -= x_dot_z * zz;
   norm(xx, xy, xz);
 
@@ -118,7 +128,7 @@ Interp Core::interpretOne(const std::array<double,16>& M) {
   norm(yx, yy, yz);
 
   // Возвращаем полный базис + позицию
-  Interp out{};
+  Frame out{};
   out.x = px; out.y = py; out.z = pz;
   out.xx = xx; out.xy = xy; out.xz = xz;
   out.yx = yx; out.yy = yy; out.yz = yz;
@@ -126,23 +136,83 @@ Interp Core::interpretOne(const std::array<double,16>& M) {
   return out;
 }
 
-Results Core::interpretAll(const std::vector<std::array<double,16>>& transforms) {
-  Results r;
-  r.reserve(transforms.size());
-  for (const auto& t : transforms) r.push_back(interpretOne(t));
-  return r;
+// ---- Публичный фасад ----
+template <class Scalar>
+void BasicCore<Scalar>::setInput(const Snapshot& s) {
+  // Первое звено, отличающееся от прошлого ввода: всё до него в кэше остаётся верным
+  const size_t common = std::min(s.size(), input_.size());
+  size_t first = 0;
+  while (first < common && sameJoint(s[first], input_[first])) ++first;
+
+  input_ = s;
+  dirtyFrom_ = std::min(dirtyFrom_, first);
+}
+
+template <class Scalar>
+void BasicCore<Scalar>::setJointTheta(size_t joint, double theta_deg) {
+  if (joint >= input_.size()) return;
+  if (input_[joint].theta_deg == theta_deg) return;
+
+  input_[joint].theta_deg = theta_deg;
+  dirtyFrom_ = std::min(dirtyFrom_, joint);
 }
 
-// ---- Публичный фасад ----
-Results Core::computeForwardKinematics() const {
-  // 1) Нормализуем единицы (theta->rad)
-  const Snapshot s = normalizeUnits(input());
+template <class Scalar>
+typename BasicCore<Scalar>::Frames BasicCore<Scalar>::computeForwardKinematics() {
+  Frames out;
+  computeForwardKinematics(out);
+  return out;
+}
+
+template <class Scalar>
+void BasicCore<Scalar>::computeForwardKinematics(Frames& out) {
+  const size_t n = input_.size();
+  const size_t first = std::min({ dirtyFrom_, n, transforms_.size() });
 
-  // 2) Композиция всех T0->i
-  std::vector<std::array<double,16>> transforms;
-  composeAll(s, transforms);
+  // 1) Композиция T0->i только для изменённого хвоста
+  composeFrom(input_, first, transforms_);
 
-  // 3) Интерпретация
-  return interpretAll(transforms);
+  // 2) Интерпретация того же хвоста
+  results_.resize(n);
+  for (size_t i = first; i < n; ++i) results_[i] = interpretOne(transforms_[i]);
+
+  dirtyFrom_ = n;
+
+  // 3) Отдать в буфер вызывающего (assign не выделяет память, если ёмкости хватает)
+  out.assign(results_.begin(), results_.end());
+}
+
+// ---- Пакетный режим ----
+template <class Scalar>
+void BasicCore<Scalar>::computeForwardKinematicsBatch(const Snapshot& chain,
+                                                      const double* thetas_deg,
+                                                      size_t samples,
+                                                      Frames& out,
+                                                      BatchOutput mode) {
+  if constexpr (std::is_same_v<Scalar, double>) {
+    // Постоянная часть цепи разбирается один раз на весь пакет
+    CompiledChain(chain).computeBatch(thetas_deg, samples, out, mode);
+  } else {
+    const size_t dof = chain.size();
+    const bool tcpOnly = (mode == BatchOutput::TcpOnly);
+    out.resize(dof == 0 ? 0 : (tcpOnly ? samples : samples * dof));
+    if (dof == 0) return;
+
+    // Один рабочий снимок и кэш T0->i на весь пакет
+    Snapshot s = chain;
+    std::vector<Matrix> transforms;
+    for (size_t k = 0; k < samples; ++k) {
+      const double* th = thetas_deg + k * dof;
+      for (size_t j = 0; j < dof; ++j) s[j].theta_deg = th[j];
+      composeFrom(s, 0, transforms);
+      if (tcpOnly) {
+        out[k] = interpretOne(transforms.back());
+      } else {
+        for (size_t j = 0; j < dof; ++j) out[k * dof + j] = interpretOne(transforms[j]);
+      }
+    }
+  }
 }
 
+template class BasicCore<double>;
+template class BasicCore<float>;
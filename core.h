@@ -1,43 +1,115 @@
 #pragma once
 #include "initaldate.h"
 #include <array>
+#include <cstddef>
 
-class Core {
+// Общие для всех BasicCore<Scalar> типы: Core::BatchOutput и CoreF::BatchOutput — один тип
+struct CoreTypes {
+  // Что писать в выход пакетного режима: все кадры Joint0..JointN-1 или только TCP (последний кадр)
+  enum class BatchOutput { AllFrames, TcpOnly };
+};
+
+// Ядро прямой кинематики. Scalar — тип расчёта и результата:
+//   Core  = BasicCore<double> — эталон (UI, IK, Якобиан);
+//   CoreF = BasicCore<float>  — вдвое меньше памяти на кадр, для рендера, выборок и коллизий.
+// Вход (Snapshot) всегда в double: градусы -> радианы считаются в double (точность на больших
+// углах), дальше cos/sin, длины звеньев и все произведения — в Scalar.
+// Погрешность float относительно double — FloatBound ниже.
+template <class Scalar>
+class BasicCore : public CoreTypes {
 public:
-  Core() = default;
+  using Frame   = InterpT<Scalar>;
+  using Frames  = ResultsT<Scalar>;
+  using Matrix  = std::array<Scalar,16>;
 
-  // Входные данные (снимок DH)
-  void setInput(const Snapshot& s) { input_ = s; }
+  BasicCore() = default;
+
+  // Входные данные (снимок DH). Звенья, совпавшие с прошлым input() от начала цепи,
+  // не пересчитываются при следующем computeForwardKinematics().
+  void setInput(const Snapshot& s);
   const Snapshot& input() const { return input_; }
 
+  // Поменять theta одного сустава (градусы); следующий расчёт начнётся с этого звена.
+  // Индекс вне цепи — игнорируется.
+  void setJointTheta(size_t joint, double theta_deg);
+
   // Главный фасад: прям. кинематика по текущему input()
-  // Возвращает интерпретированные данные для каждого звена (Joint0..JointN-1)
-  Results computeForwardKinematics() const;
+  // Возвращает интерпретированные данные для каждого звена (Joint0..JointN-1).
+  // Инкрементально: T0->i до первого изменённого звена берутся из кэша прошлого расчёта.
+  Frames computeForwardKinematics();
+
+  // То же, но в буфер вызывающего (для цикла управления реального времени).
+  // out переиспользуется: при неизменном числе звеньев вызов не делает ни одной
+  // аллокации (кэш T0->i и input() тоже растут только при увеличении цепи).
+  // Проверка — AllocCounter (alloc_counter.h), robotdh_bench --check (alloc.core.fk).
+  void computeForwardKinematics(Frames& out);
+
+  // ---- Пакетный режим (офлайн-проверка траекторий) ----
+  // Прямая кинематика для N конфигураций одной цепи.
+  // chain      — геометрия цепи: a, d, alpha берутся отсюда, theta_deg игнорируется;
+  // thetas_deg — блок N x DOF углов theta в градусах, построчно (конфигурация за конфигурацией);
+  // out        — AllFrames: N*DOF кадров (выборка i, звено j -> out[i*DOF + j]); TcpOnly: N кадров.
+  // Не копирует Snapshot на каждую выборку и не выделяет память внутри цикла
+  // (double — через CompiledChain, см. compiled_chain.h; float — своим циклом).
+  static void computeForwardKinematicsBatch(const Snapshot& chain,
+                                            const double* thetas_deg,
+                                            size_t samples,
+                                            Frames& out,
+                                            BatchOutput mode = BatchOutput::AllFrames);
+
+  // Интерпретировать одну T0->i (позиция + орто-нормированный базис).
+  // Открыта для специализированных цепей (fixed_chain.h), чтобы интерпретация была одна на всех.
+  static Frame interpretOne(const Matrix& Tflat);
 
 private:
+  // Микробенчмарки приватной математики (robotdh_bench.cpp)
+  friend struct CoreBenchAccess;
+
   // ---- Вспомогательная математика (классический DH) ----
   // Единичная 4x4
-  static void identity(double T[4][4]);
+  static void identity(Scalar T[4][4]);
 
   // Умножение 4x4: Out = L * R
-  static void mul(const double L[4][4], const double R[4][4], double Out[4][4]);
+  static void mul(const Scalar L[4][4], const Scalar R[4][4], Scalar Out[4][4]);
 
   // Локальная DH-матрица A_i(theta,a,d,alpha): Rz(theta)*Tz(d)*Tx(a)*Rx(alpha)
-  static void makeA(double theta_rad, double a_m, double d_m, double alpha_rad, double A[4][4]);
-
-  // Нормализация единиц: theta_deg->rad; alpha уже в rad; a,d — метры (без изменений)
-  static Snapshot normalizeUnits(const Snapshot& s);
+  static void makeA(double theta_rad, double a_m, double d_m, double alpha_rad, Scalar A[4][4]);
 
-  // Накопить все T0->i
-  static void composeAll(const Snapshot& s, std::vector<std::array<double,16>>& transforms);
+  // Пересчитать T0->i для i >= first (theta в градусах, переводится на лету).
+  // transforms[0..first) должны быть актуальны; размер приводится к s.size().
+  static void composeFrom(const Snapshot& s, size_t first, std::vector<Matrix>& transforms);
 
-  // Интерпретировать одну T0->i
-  static Interp interpretOne(const std::array<double,16>& Tflat);
-
-  // Интерпретировать все
-  static Results interpretAll(const std::vector<std::array<double,16>>& transforms);
+  // Одинаковы ли два звена (для поиска первого изменённого)
+  static bool sameJoint(const JointDH& l, const JointDH& r);
 
 private:
   Snapshot input_{};
+
+  // Кэш последнего расчёта: T0->i и их интерпретация.
+  // Всё начиная с dirtyFrom_ устарело; dirtyFrom_ >= размера цепи — кэш полностью актуален.
+  std::vector<Matrix> transforms_;
+  Frames results_;
+  size_t dirtyFrom_ = 0;
 };
 
+// Определения — в core.cpp, здесь только два экземпляра
+extern template class BasicCore<double>;
+extern template class BasicCore<float>;
+
+using Core  = BasicCore<double>;
+using CoreF = BasicCore<float>;
+
+// ---- Допуск float-режима относительно double ----
+// Оценка сверху для цепи из dof звеньев (накопление округлений линейно по длине цепи):
+//   позиция:   |p_float - p_double| <= position(dof, reach),  reach = sum(|a_i| + |d_i|), метры;
+//   оси (X,Y,Z кадра, единичные): покомпонентно <= axis(dof).
+// Оценка позиции — худший случай (ошибка поворота на полном вылете цепи). Проверяется на
+// случайных конфигурациях для dof <= kMaxCheckedDof (robotdh_bench --check): фактическая
+// ошибка осей в 5-10 раз, позиции в 10-100 раз меньше оценки.
+namespace FloatBound {
+constexpr double kEpsilon = 1.1920928955078125e-07;  // FLT_EPSILON
+constexpr size_t kMaxCheckedDof = 64;
+
+constexpr double axis(size_t dof) { return 4.0 * double(dof + 1) * kEpsilon; }
+constexpr double position(size_t dof, double reach_m) { return axis(dof) * (reach_m > 1.0 ? reach_m : 1.0); }
+} // namespace FloatBound
@@ -0,0 +1,91 @@
+#pragma once
+// Векторный полиномиальный sincos для пакетной FK (fk_simd_kernel.h).
+// Как и ядро, подключается из единиц трансляции с разными флагами ISA, поэтому здесь
+// только POD и шаблоны над "упаковкой" P (см. PackScalar/PackSse2/PackAvx2/PackAvx512).
+//
+// Угол приходит в градусах, как в Snapshot: четверть оборота (90°) представима точно,
+// поэтому приведение к [-45°, 45°] не теряет точности и не требует разложения pi на части.
+// Дальше — полиномы по x в радианах (|x| <= pi/4) и выбор квадранта без ветвлений.
+
+namespace FastTrig {
+
+// Точность sin/cos (абсолютная ошибка). Приведение точно для |угол| < 2^46 градусов;
+// эталон std::cos(deg*pi/180) на больших углах сам теряет ~ulp(угла в радианах)
+enum class Accuracy {
+  Libm,      // std::sin/std::cos по дорожкам — эталон, по умолчанию
+  PolyFull,  // полином Cephes, ~1e-16 (на уровне округления double)
+  Poly1e9,   // ряд Тейлора до x^11 / x^10, <= 2e-10
+  Poly1e6,   // ряд Тейлора до x^7 / x^8, <= 4e-7
+};
+
+constexpr double kDeg2Rad = 3.14159265358979323846 / 180.0;
+
+// s = sin(deg), c = cos(deg) по всем дорожкам; A != Libm
+template <class P, Accuracy A>
+inline void sincosDeg(typename P::V deg, typename P::V& s, typename P::V& c) {
+  using V = typename P::V;
+  static_assert(A != Accuracy::Libm, "FastTrig::sincosDeg: Libm считается вызывающим");
+
+  // round(v) = (v + 1.5*2^52) - 1.5*2^52 — без SSE4.1/AVX-округлений, к ближайшему чётному
+  const V magic = P::set1(6755399441055744.0);
+  auto round = [&](V v) { return P::sub(P::add(v, magic), magic); };
+
+  // deg = q*90 + r, |r| <= 45 (+ошибка 1/90); q*90 точно
+  const V q = round(P::mul(deg, P::set1(1.0 / 90.0)));
+  const V x = P::mul(P::sub(deg, P::mul(q, P::set1(90.0))), P::set1(kDeg2Rad));
+
+  // Квадрант m = q mod 4 в 0..3
+  V m = P::sub(q, P::mul(round(P::mul(q, P::set1(0.25))), P::set1(4.0)));  // -2..2
+  m = P::selectGreater(m, -0.5, m, P::add(m, P::set1(4.0)));
+
+  // sin x = x + x*z*Ps(z), cos x = 1 - z/2 + z*z*Pc(z), z = x^2
+  const V z = P::mul(x, x);
+  V ps, pc;
+  if constexpr (A == Accuracy::PolyFull) {
+    ps = P::set1( 1.58962301576546568060e-10);
+    ps = P::add(P::mul(ps, z), P::set1(-2.50507477628578072866e-8));
+    ps = P::add(P::mul(ps, z), P::set1( 2.75573136213857245213e-6));
+    ps = P::add(P::mul(ps, z), P::set1(-1.98412698295895385996e-4));
+    ps = P::add(P::mul(ps, z), P::set1( 8.33333333332211858878e-3));
+    ps = P::add(P::mul(ps, z), P::set1(-1.66666666666666307295e-1));
+
+    pc = P::set1(-1.13585365213876817300e-11);
+    pc = P::add(P::mul(pc, z), P::set1( 2.08757008419747316778e-9));
+    pc = P::add(P::mul(pc, z), P::set1(-2.75573141792967388112e-7));
+    pc = P::add(P::mul(pc, z), P::set1( 2.48015872888517045348e-5));
+    pc = P::add(P::mul(pc, z), P::set1(-1.38888888888730564116e-3));
+    pc = P::add(P::mul(pc, z), P::set1( 4.16666666666665929218e-2));
+  } else if constexpr (A == Accuracy::Poly1e9) {
+    ps = P::set1(-1.0 / 39916800.0);
+    ps = P::add(P::mul(ps, z), P::set1( 1.0 / 362880.0));
+    ps = P::add(P::mul(ps, z), P::set1(-1.0 / 5040.0));
+    ps = P::add(P::mul(ps, z), P::set1( 1.0 / 120.0));
+    ps = P::add(P::mul(ps, z), P::set1(-1.0 / 6.0));
+
+    pc = P::set1(-1.0 / 3628800.0);
+    pc = P::add(P::mul(pc, z), P::set1( 1.0 / 40320.0));
+    pc = P::add(P::mul(pc, z), P::set1(-1.0 / 720.0));
+    pc = P::add(P::mul(pc, z), P::set1( 1.0 / 24.0));
+  } else {
+    ps = P::set1(-1.0 / 5040.0);
+    ps = P::add(P::mul(ps, z), P::set1( 1.0 / 120.0));
+    ps = P::add(P::mul(ps, z), P::set1(-1.0 / 6.0));
+
+    pc = P::set1( 1.0 / 40320.0);
+    pc = P::add(P::mul(pc, z), P::set1(-1.0 / 720.0));
+    pc = P::add(P::mul(pc, z), P::set1( 1.0 / 24.0));
+  }
+  const V sx = P::add(x, P::mul(P::mul(x, z), ps));
+  const V cx = P::add(P::sub(P::set1(1.0), P::mul(z, P::set1(0.5))), P::mul(P::mul(z, z), pc));
+
+  // sin(x + m*90°): m=0 (s, c), 1 (c, -s), 2 (-s, -c), 3 (-c, s)
+  auto odd = [&](V a, V b) {   // m нечётный ? a : b
+    return P::selectGreater(m, 2.5, a, P::selectGreater(m, 1.5, b, P::selectGreater(m, 0.5, a, b)));
+  };
+  const V s0 = odd(cx, sx);
+  const V c0 = odd(sx, cx);
+  s = P::selectGreater(m, 1.5, P::neg(s0), s0);
+  c = P::selectGreater(m, 2.5, c0, P::selectGreater(m, 0.5, P::neg(c0), c0));
+}
+
+} // namespace FastTrig
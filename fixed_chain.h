@@ -0,0 +1,205 @@
+#pragma once
+#include "core.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Специализированные цепи с числом звеньев, известным при компиляции.
+// Для горячих циклов: произведение звеньев разворачивается полностью, накопленная матрица —
+// 12 локальных double (нижняя строка [0 0 0 1] не хранится), без std::vector и аллокаций.
+// Универсальный Core (любой длины, для UI) остаётся как есть.
+//
+//   FixedChain<6> chain(Presets::kTZ6);    // N в типе, a/d/alpha — в рантайме
+//   ConstChain<Presets::kTZ6> tz6;         // и N, и a/d/alpha — константы компиляции
+//
+// Углы theta — в градусах, как в Snapshot. Интерпретация кадров — Core::interpretOne.
+namespace FixedDH {
+
+// Вид угла alpha: для частых значений тригонометрия сворачивается в 0/±1
+enum class AlphaKind { General, Zero, PlusHalfPi, MinusHalfPi };
+
+constexpr AlphaKind classifyAlpha(double alpha_rad) {
+  constexpr double halfPi = 3.14159265358979323846 / 2.0;
+  constexpr double eps = 1e-15;
+  if (alpha_rad == 0.0) return AlphaKind::Zero;
+  if (alpha_rad - halfPi < eps && halfPi - alpha_rad < eps) return AlphaKind::PlusHalfPi;
+  if (alpha_rad + halfPi < eps && -halfPi - alpha_rad < eps) return AlphaKind::MinusHalfPi;
+  return AlphaKind::General;
+}
+
+// Верхние 3 строки T0->i
+struct Affine { double m[3][4]; };
+
+inline Affine identityAffine() {
+  return Affine{{ {1.0, 0.0, 0.0, 0.0},
+                  {0.0, 1.0, 0.0, 0.0},
+                  {0.0, 0.0, 1.0, 0.0} }};
+}
+
+// C = C * A(theta, a, d, alpha). Kind/HasA/HasD известны при компиляции —
+// лишние умножения на 0/1 просто не генерируются. Для General ca/sa берутся из аргументов.
+template <AlphaKind Kind, bool HasA, bool HasD>
+inline void step(Affine& C, double ct, double st, double ca, double sa, double a, double d) {
+  for (int r = 0; r < 3; ++r) {
+    double* row = C.m[r];
+    const double r0 = row[0], r1 = row[1], r2 = row[2], r3 = row[3];
+
+    row[0] = r0*ct + r1*st;
+
+    if constexpr (Kind == AlphaKind::Zero) {
+      row[1] = r1*ct - r0*st;
+      row[2] = r2;
+    } else if constexpr (Kind == AlphaKind::PlusHalfPi) {
+      row[1] = r2;
+      row[2] = r0*st - r1*ct;
+    } else if constexpr (Kind == AlphaKind::MinusHalfPi) {
+      row[1] = -r2;
+      row[2] = r1*ct - r0*st;
+    } else {
+      row[1] = r0*(-st*ca) + r1*(ct*ca) + r2*sa;
+      row[2] = r0*(st*sa)  + r1*(-ct*sa) + r2*ca;
+    }
+
+    double t = r3;
+    if constexpr (HasA) t += a * row[0];
+    if constexpr (HasD) t += r2 * d;
+    row[3] = t;
+  }
+}
+
+// Affine -> плоская 4x4 для Core::interpretOne
+inline Interp interpret(const Affine& C) {
+  const std::array<double,16> flat = {
+    C.m[0][0], C.m[0][1], C.m[0][2], C.m[0][3],
+    C.m[1][0], C.m[1][1], C.m[1][2], C.m[1][3],
+    C.m[2][0], C.m[2][1], C.m[2][2], C.m[2][3],
+    0.0,       0.0,       0.0,       1.0
+  };
+  return Core::interpretOne(flat);
+}
+
+// Вернуть поворотную часть C к ортонормированной (тот же порядок, что в Core::interpretOne:
+// Z нормируется, X проецируется на плоскость _|_ Z, Y = Z x X). Позиция не трогается.
+inline void reorthonormalize(Affine& C) {
+  double xx = C.m[0][0], xy = C.m[1][0], xz = C.m[2][0];
+  double zx = C.m[0][2], zy = C.m[1][2], zz = C.m[2][2];
+  auto norm = [](double& a, double& b, double& c) {
+    const double n = std::sqrt(a*a + b*b + c*c);
+    if (n > 1e-12) { a /= n; b /= n; c /= n; }
+  };
+  norm(zx, zy, zz);
+  const double xdz = xx*zx + xy*zy + xz*zz;
+  xx -= xdz * zx; xy -= xdz * zy; xz -= xdz * zz;
+  norm(xx, xy, xz);
+  C.m[0][0] = xx;            C.m[1][0] = xy;            C.m[2][0] = xz;
+  C.m[0][1] = zy*xz - zz*xy; C.m[1][1] = zz*xx - zx*xz; C.m[2][1] = zx*xy - zy*xx;
+  C.m[0][2] = zx;            C.m[1][2] = zy;            C.m[2][2] = zz;
+}
+
+constexpr double kDeg2Rad = 3.14159265358979323846 / 180.0;
+
+} // namespace FixedDH
+
+// ---- N известно при компиляции, геометрия — в рантайме ----
+template <size_t N>
+class FixedChain {
+  static_assert(N > 0, "FixedChain: нужен хотя бы один сустав");
+public:
+  using Thetas = std::array<double, N>;   // углы theta, градусы
+  using Frames = std::array<Interp, N>;   // кадры Joint0..JointN-1
+
+  // Из массива звеньев (например, Presets::kTZ6); theta звеньев не используется
+  explicit FixedChain(const JointDH (&links)[N]) {
+    for (size_t i = 0; i < N; ++i) setLink(i, links[i]);
+  }
+
+  // Из Snapshot той же длины; false — длина не совпала (цепь не тронута)
+  bool assign(const Snapshot& s) {
+    if (s.size() != N) return false;
+    for (size_t i = 0; i < N; ++i) setLink(i, s[i]);
+    return true;
+  }
+
+  // Все кадры
+  void compute(const Thetas& theta_deg, Frames& out) const {
+    FixedDH::Affine C = FixedDH::identityAffine();
+    run(theta_deg, C, &out, std::make_index_sequence<N>{});
+  }
+
+  // Только TCP (промежуточные кадры не интерпретируются)
+  Interp tcp(const Thetas& theta_deg) const {
+    FixedDH::Affine C = FixedDH::identityAffine();
+    run(theta_deg, C, static_cast<Frames*>(nullptr), std::make_index_sequence<N>{});
+    return FixedDH::interpret(C);
+  }
+
+private:
+  struct Link { double ca, sa, a, d; };
+
+  void setLink(size_t i, const JointDH& j) {
+    links_[i] = Link{ std::cos(j.alpha_rad), std::sin(j.alpha_rad), j.a_m, j.d_m };
+  }
+
+  template <size_t... I>
+  void run(const Thetas& th, FixedDH::Affine& C, Frames* out, std::index_sequence<I...>) const {
+    (stepAt<I>(th[I], C, out), ...);
+  }
+
+  template <size_t I>
+  void stepAt(double theta_deg, FixedDH::Affine& C, Frames* out) const {
+    const double t = theta_deg * FixedDH::kDeg2Rad;
+    const Link& L = links_[I];
+    FixedDH::step<FixedDH::AlphaKind::General, true, true>(C, std::cos(t), std::sin(t), L.ca, L.sa, L.a, L.d);
+    if (out) (*out)[I] = FixedDH::interpret(C);
+  }
+
+  std::array<Link, N> links_{};
+};
+
+// ---- И N, и геометрия — константы компиляции ----
+// Links — constexpr-массив JointDH со статическим временем жизни (Presets::kTZ6).
+// alpha из {0, +pi/2, -pi/2} сворачивается в точные 0/±1, нулевые a/d выпадают из кода.
+// Из-за точных 0/±1 результат может отличаться от Core на ~1e-16 (cos(pi/2) != 0 в double).
+template <const auto& Links>
+class ConstChain {
+  using LinksT = std::remove_cv_t<std::remove_reference_t<decltype(Links)>>;
+public:
+  static constexpr size_t N = std::extent_v<LinksT>;
+  static_assert(N > 0, "ConstChain: нужен хотя бы один сустав");
+
+  using Thetas = std::array<double, N>;
+  using Frames = std::array<Interp, N>;
+
+  static void compute(const Thetas& theta_deg, Frames& out) {
+    FixedDH::Affine C = FixedDH::identityAffine();
+    run(theta_deg, C, &out, std::make_index_sequence<N>{});
+  }
+
+  static Interp tcp(const Thetas& theta_deg) {
+    FixedDH::Affine C = FixedDH::identityAffine();
+    run(theta_deg, C, static_cast<Frames*>(nullptr), std::make_index_sequence<N>{});
+    return FixedDH::interpret(C);
+  }
+
+private:
+  template <size_t... I>
+  static void run(const Thetas& th, FixedDH::Affine& C, Frames* out, std::index_sequence<I...>) {
+    (stepAt<I>(th[I], C, out), ...);
+  }
+
+  template <size_t I>
+  static void stepAt(double theta_deg, FixedDH::Affine& C, Frames* out) {
+    constexpr JointDH L = Links[I];
+    constexpr FixedDH::AlphaKind kind = FixedDH::classifyAlpha(L.alpha_rad);
+    const double t = theta_deg * FixedDH::kDeg2Rad;
+
+    // Для General cos/sin(alpha) от константы — компилятор считает их сам
+    const double ca = (kind == FixedDH::AlphaKind::General) ? std::cos(L.alpha_rad) : 0.0;
+    const double sa = (kind == FixedDH::AlphaKind::General) ? std::sin(L.alpha_rad) : 0.0;
+
+    FixedDH::step<kind, (L.a_m != 0.0), (L.d_m != 0.0)>(C, std::cos(t), std::sin(t), ca, sa, L.a_m, L.d_m);
+    if (out) (*out)[I] = FixedDH::interpret(C);
+  }
+};
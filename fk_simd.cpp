@@ -0,0 +1,232 @@
+#include "fk_simd.h"
+#include "fk_simd_kernel.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(ROBOTDH_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Скалярная "упаковка" из одной дорожки — тот же шаблон ядра, без SIMD
+struct PackScalar {
+  using V = double;
+  static constexpr int W = 1;
+  static V zero()                   { return 0.0; }
+  static V set1(double v)           { return v; }
+  static V load(const double* p)    { return *p; }
+  static void store(double* p, V v) { *p = v; }
+  static V add(V a, V b)            { return a + b; }
+  static V sub(V a, V b)            { return a - b; }
+  static V mul(V a, V b)            { return a * b; }
+  static V div(V a, V b)            { return a / b; }
+  static V neg(V a)                 { return -a; }
+  static V sqrt(V a)                { return std::sqrt(a); }
+  static V selectGreater(V x, double thr, V a, V b) { return (x > thr) ? a : b; }
+};
+
+// ---- Что умеет CPU ----
+bool cpuHasSse2() {
+#if !defined(ROBOTDH_SIMD_X86)
+  return false;
+#elif defined(_MSC_VER)
+  int r[4];
+  __cpuid(r, 1);
+  return (r[3] & (1 << 26)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAvx2() {
+#if !defined(ROBOTDH_SIMD_X86)
+  return false;
+#elif defined(_MSC_VER)
+  int r[4];
+  __cpuid(r, 1);
+  const bool osxsave = (r[2] & (1 << 27)) != 0;
+  const bool avx     = (r[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx) return false;
+  if ((_xgetbv(0) & 0x6) != 0x6) return false;   // ОС сохраняет XMM+YMM
+  __cpuidex(r, 7, 0);
+  return (r[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasAvx512() {
+#if !defined(ROBOTDH_SIMD_X86)
+  return false;
+#elif defined(_MSC_VER)
+  if (!cpuHasAvx2()) return false;
+  if ((_xgetbv(0) & 0xE6) != 0xE6) return false; // ОС сохраняет opmask + ZMM
+  int r[4];
+  __cpuidex(r, 7, 0);
+  return (r[1] & (1 << 16)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f");
+#endif
+}
+
+FkSimd::detail::KernelFn kernelFor(FkSimd::Isa isa) {
+  using namespace FkSimd::detail;
+  switch (isa) {
+#if defined(ROBOTDH_SIMD_X86)
+    case FkSimd::Isa::AVX512: return &kernelAvx512;
+    case FkSimd::Isa::AVX2:   return &kernelAvx2;
+    case FkSimd::Isa::SSE2:   return &kernelSse2;
+#endif
+    default:                  return &kernelScalar;
+  }
+}
+
+} // namespace
+
+void FkSimd::detail::kernelScalar(const Links& L, const double* thetas_deg, Strides str, size_t samples,
+                                  const Output& out, bool tcpOnly, Accuracy trig) {
+  runKernel<PackScalar>(L, thetas_deg, str, samples, out, tcpOnly, trig);
+}
+
+namespace FkSimd {
+
+Isa detectIsa() {
+  // Определяем один раз на процесс
+  static const Isa best = [] {
+    if (cpuHasAvx512()) return Isa::AVX512;
+    if (cpuHasAvx2())   return Isa::AVX2;
+    if (cpuHasSse2())   return Isa::SSE2;
+    return Isa::Scalar;
+  }();
+  return best;
+}
+
+const char* isaName(Isa isa) {
+  switch (isa) {
+    case Isa::SSE2:   return "sse2";
+    case Isa::AVX2:   return "avx2";
+    case Isa::AVX512: return "avx512";
+    default:          return "scalar";
+  }
+}
+
+int lanes(Isa isa) {
+  switch (isa) {
+    case Isa::SSE2:   return 2;
+    case Isa::AVX2:   return 4;
+    case Isa::AVX512: return 8;
+    default:          return 1;
+  }
+}
+
+void computeBatch(const Snapshot& chain,
+                  const double* thetas_deg,
+                  size_t samples,
+                  Results& out,
+                  Core::BatchOutput mode,
+                  Isa isa,
+                  FastTrig::Accuracy trig) {
+  computeBatchStrided(chain, thetas_deg, samples, chain.size(), 1, out, mode, isa, trig);
+}
+
+namespace {
+
+// Общая часть обоих видов выхода: постоянные звеньев в SoA-виде и вызов ядра
+void run(const Snapshot& chain, const double* thetas_deg, size_t samples, detail::Strides str,
+         const detail::Output& out, bool tcpOnly, Isa isa, FastTrig::Accuracy trig) {
+  // Не выше того, что есть на этом CPU
+  const Isa best = detectIsa();
+  if (static_cast<int>(isa) > static_cast<int>(best)) isa = best;
+
+  const size_t dof = chain.size();
+  std::vector<double> ca(dof), sa(dof), a(dof), d(dof);
+  for (size_t k = 0; k < dof; ++k) {
+    ca[k] = std::cos(chain[k].alpha_rad);
+    sa[k] = std::sin(chain[k].alpha_rad);
+    a[k]  = chain[k].a_m;
+    d[k]  = chain[k].d_m;
+  }
+  const detail::Links links{ ca.data(), sa.data(), a.data(), d.data(), dof };
+
+  kernelFor(isa)(links, thetas_deg, str, samples, out, tcpOnly, trig);
+}
+
+} // namespace
+
+void computeBatchStrided(const Snapshot& chain,
+                         const double* thetas_deg,
+                         size_t samples,
+                         size_t sampleStride,
+                         size_t jointStride,
+                         Results& out,
+                         Core::BatchOutput mode,
+                         Isa isa,
+                         FastTrig::Accuracy trig) {
+  out.clear();
+  const size_t dof = chain.size();
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  const bool tcpOnly = (mode == Core::BatchOutput::TcpOnly);
+  out.resize(tcpOnly ? samples : samples * dof);
+
+  detail::Output o{};
+  for (int c = 0; c < 12; ++c) o.field[c] = &out[0].x + c;
+  o.sample = (tcpOnly ? 1 : dof) * 12;
+  o.frame  = tcpOnly ? 0 : 12;
+  run(chain, thetas_deg, samples, detail::Strides{ sampleStride, jointStride }, o, tcpOnly, isa, trig);
+}
+
+void computeBatch(const Snapshot& chain,
+                  const double* thetas_deg,
+                  size_t samples,
+                  ResultsSoA& out,
+                  Core::BatchOutput mode,
+                  ResultsSoA::Content content,
+                  Isa isa,
+                  FastTrig::Accuracy trig) {
+  computeBatchStrided(chain, thetas_deg, samples, chain.size(), 1, out, mode, content, isa, trig);
+}
+
+void computeBatchStrided(const Snapshot& chain,
+                         const double* thetas_deg,
+                         size_t samples,
+                         size_t sampleStride,
+                         size_t jointStride,
+                         ResultsSoA& out,
+                         Core::BatchOutput mode,
+                         ResultsSoA::Content content,
+                         Isa isa,
+                         FastTrig::Accuracy trig) {
+  out.clear();
+  const size_t dof = chain.size();
+  if (dof == 0 || samples == 0 || !thetas_deg) return;
+
+  const bool tcpOnly = (mode == Core::BatchOutput::TcpOnly);
+  out.resize(samples, tcpOnly ? 1 : dof, content);
+
+  detail::Output o{};
+  for (int c = 0; c < out.fields(); ++c) o.field[c] = out.column(c, 0);
+  o.sample = out.sampleStride();
+  o.frame  = tcpOnly ? 0 : out.frameStride();
+  run(chain, thetas_deg, samples, detail::Strides{ sampleStride, jointStride }, o, tcpOnly, isa, trig);
+}
+
+double trigTolerance(FastTrig::Accuracy trig, size_t dof, double reach_m) {
+  // Ошибка sin/cos eps даёт поворот звена на ~eps: оси уходят на dof*eps,
+  // позиции — на dof*eps*вылет. Множитель 2 — запас на сумму ошибок sin и cos.
+  double eps = 0.0;
+  switch (trig) {
+    case FastTrig::Accuracy::PolyFull: eps = 1e-15; break;
+    case FastTrig::Accuracy::Poly1e9:  eps = 2e-10; break;
+    case FastTrig::Accuracy::Poly1e6:  eps = 4e-7;  break;
+    default:                           return kTolerance;
+  }
+  return std::max(kTolerance, 2.0 * eps * double(dof) * std::max(1.0, reach_m));
+}
+
+} // namespace FkSimd
@@ -0,0 +1,80 @@
+#pragma once
+#include "core.h"
+#include "fast_trig.h"
+#include "results_soa.h"
+
+// Векторное ядро прямой кинематики: несколько конфигураций за раз,
+// по одной в каждой дорожке SIMD-регистра (структура массивов).
+// Набор инструкций выбирается в рантайме; скалярный вариант есть всегда.
+namespace FkSimd {
+
+enum class Isa { Scalar, SSE2, AVX2, AVX512 };
+
+// Лучший набор инструкций, который поддерживает CPU и который собран в бинарник
+Isa detectIsa();
+
+// Имя для логов/бенчмарков ("scalar", "sse2", "avx2", "avx512")
+const char* isaName(Isa isa);
+
+// Сколько конфигураций обрабатывается за один проход ядра (1, 2, 4, 8)
+int lanes(Isa isa);
+
+// Допуск совпадения с Core::composeFrom + Core::interpretOne:
+// абсолютная ошибка на компоненту Interp (позиции в метрах, оси безразмерные)
+// для цепей до ~64 звеньев с |a|,|d| порядка метров. Разница возникает только
+// из-за слияния умножения и сложения (FMA), которое компилятор может применить в AVX-ядрах.
+constexpr double kTolerance = 1e-12;
+
+// Семантика и раскладка выхода — как у Core::computeForwardKinematicsBatch.
+// Если запрошенный isa недоступен, берётся лучший доступный не выше запрошенного.
+// trig — sin/cos(theta): Libm (по умолчанию, kTolerance выше) или векторный полином
+// (fast_trig.h); тогда ошибка кадра ~ dof * (точность уровня) * вылет цепи, см. trigTolerance.
+void computeBatch(const Snapshot& chain,
+                  const double* thetas_deg,
+                  size_t samples,
+                  Results& out,
+                  Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                  Isa isa = detectIsa(),
+                  FastTrig::Accuracy trig = FastTrig::Accuracy::Libm);
+
+// То же с произвольной раскладкой углов: theta сустава j выборки i —
+// thetas_deg[i*sampleStride + j*jointStride]. Построчно: (dof, 1); по столбцам: (1, samples) —
+// так можно считать прямо по столбцовому файлу траектории (trajectory_file.h) без копии.
+void computeBatchStrided(const Snapshot& chain,
+                         const double* thetas_deg,
+                         size_t samples,
+                         size_t sampleStride,
+                         size_t jointStride,
+                         Results& out,
+                         Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                         Isa isa = detectIsa(),
+                         FastTrig::Accuracy trig = FastTrig::Accuracy::Libm);
+
+// То же с выходом в структуру массивов (results_soa.h): ядро пишет столбцы напрямую,
+// out размечается здесь (samples x dof или x 1 при TcpOnly). Content::Positions — только
+// позиции кадров: оси не ортонормируются и не пишутся.
+void computeBatch(const Snapshot& chain,
+                  const double* thetas_deg,
+                  size_t samples,
+                  ResultsSoA& out,
+                  Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                  ResultsSoA::Content content = ResultsSoA::Content::Frames,
+                  Isa isa = detectIsa(),
+                  FastTrig::Accuracy trig = FastTrig::Accuracy::Libm);
+
+void computeBatchStrided(const Snapshot& chain,
+                         const double* thetas_deg,
+                         size_t samples,
+                         size_t sampleStride,
+                         size_t jointStride,
+                         ResultsSoA& out,
+                         Core::BatchOutput mode = Core::BatchOutput::AllFrames,
+                         ResultsSoA::Content content = ResultsSoA::Content::Frames,
+                         Isa isa = detectIsa(),
+                         FastTrig::Accuracy trig = FastTrig::Accuracy::Libm);
+
+// Допуск кадра против Core для уровня trig: на компоненту Interp, цепь из dof звеньев,
+// reach = sum(|a_i| + |d_i|) в метрах (проверяется robotdh_bench --check)
+double trigTolerance(FastTrig::Accuracy trig, size_t dof, double reach_m);
+
+} // namespace FkSimd
@@ -0,0 +1,30 @@
+// AVX2: 4 конфигурации на регистр. Собирается с -mavx2 (/arch:AVX2), вызывается только после проверки CPU.
+#include "fk_simd_kernel.h"
+#include <immintrin.h>
+
+namespace {
+struct PackAvx2 {
+  using V = __m256d;
+  static constexpr int W = 4;
+  static V zero()                 { return _mm256_setzero_pd(); }
+  static V set1(double v)         { return _mm256_set1_pd(v); }
+  static V load(const double* p)  { return _mm256_load_pd(p); }
+  static void store(double* p, V v) { _mm256_store_pd(p, v); }
+  static V add(V a, V b)          { return _mm256_add_pd(a, b); }
+  static V sub(V a, V b)          { return _mm256_sub_pd(a, b); }
+  static V mul(V a, V b)          { return _mm256_mul_pd(a, b); }
+  static V div(V a, V b)          { return _mm256_div_pd(a, b); }
+  static V neg(V a)               { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+  static V sqrt(V a)              { return _mm256_sqrt_pd(a); }
+  // (x > thr) ? a : b
+  static V selectGreater(V x, double thr, V a, V b) {
+    const V m = _mm256_cmp_pd(x, _mm256_set1_pd(thr), _CMP_GT_OQ);
+    return _mm256_blendv_pd(b, a, m);
+  }
+};
+} // namespace
+
+void FkSimd::detail::kernelAvx2(const Links& L, const double* thetas_deg, Strides str, size_t samples,
+                                const Output& out, bool tcpOnly, Accuracy trig) {
+  runKernel<PackAvx2>(L, thetas_deg, str, samples, out, tcpOnly, trig);
+}
@@ -0,0 +1,36 @@
+// AVX-512F: 8 конфигураций на регистр. Собирается с -mavx512f (/arch:AVX512), вызывается только после проверки CPU.
+#include "fk_simd_kernel.h"
+#include <immintrin.h>
+
+namespace {
+struct PackAvx512 {
+  using V = __m512d;
+  static constexpr int W = 8;
+  static V zero()                 { return _mm512_setzero_pd(); }
+  static V set1(double v)         { return _mm512_set1_pd(v); }
+  static V load(const double* p)  { return _mm512_load_pd(p); }
+  static void store(double* p, V v) { _mm512_store_pd(p, v); }
+  static V add(V a, V b)          { return _mm512_add_pd(a, b); }
+  static V sub(V a, V b)          { return _mm512_sub_pd(a, b); }
+  static V mul(V a, V b)          { return _mm512_mul_pd(a, b); }
+  static V div(V a, V b)          { return _mm512_div_pd(a, b); }
+  static V neg(V a) {
+    // xor знакового бита (_mm512_xor_pd требует AVX512DQ, поэтому через целочисленный xor)
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a),
+                                                _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL))));
+  }
+  // Маскированная форма с полной маской — та же vsqrtpd. _mm512_sqrt_pd в GCC 12 подставляет
+  // _mm512_undefined_pd() как источник и даёт ложное -Wmaybe-uninitialized
+  static V sqrt(V a)              { return _mm512_mask_sqrt_pd(a, __mmask8(0xFF), a); }
+  // (x > thr) ? a : b
+  static V selectGreater(V x, double thr, V a, V b) {
+    const __mmask8 m = _mm512_cmp_pd_mask(x, _mm512_set1_pd(thr), _CMP_GT_OQ);
+    return _mm512_mask_blend_pd(m, b, a);
+  }
+};
+} // namespace
+
+void FkSimd::detail::kernelAvx512(const Links& L, const double* thetas_deg, Strides str, size_t samples,
+                                  const Output& out, bool tcpOnly, Accuracy trig) {
+  runKernel<PackAvx512>(L, thetas_deg, str, samples, out, tcpOnly, trig);
+}
@@ -0,0 +1,183 @@
+#pragma once
+// Внутренний заголовок SIMD-ядра FK: общий шаблон + точки входа под каждый ISA.
+// Подключается из fk_simd*.cpp, которые собираются с разными флагами (-msse2/-mavx2/-mavx512f).
+// Поэтому здесь только сырые указатели и POD: никаких std-контейнеров, чьи inline-функции
+// линкер мог бы взять из AVX-единицы трансляции и выполнить на старом CPU.
+#include "initaldate.h"
+#include "fast_trig.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace FkSimd {
+namespace detail {
+
+// Постоянная часть цепи в виде структуры массивов (по dof элементов)
+struct Links {
+  const double* ca;  // cos(alpha)
+  const double* sa;  // sin(alpha)
+  const double* a;   // a, метры
+  const double* d;   // d, метры
+  size_t dof;
+};
+
+// Раскладка углов: theta сустава k выборки i — thetas_deg[i*sample + k*joint]
+// (построчно N x dof: sample = dof, joint = 1; по столбцам: sample = 1, joint = N)
+struct Strides {
+  size_t sample;
+  size_t joint;
+};
+
+// Раскладка выхода: компонента c (порядок полей Interp) кадра k выборки i —
+// field[c][i*sample + k*frame]; при tcpOnly пишется только k = dof-1, frame = 0.
+//   Results (AoS):   field[c] = &out[0].x + c, sample = 12*dof (12), frame = 12;
+//   ResultsSoA:      field[c] = столбец поля, sample = 1, frame = шаг кадра —
+//                    соседние выборки лежат подряд и пишутся в столбец целым регистром.
+// field[3..11] == nullptr — нужны только позиции: оси не считаются и не пишутся.
+struct Output {
+  double* field[12];
+  size_t sample;
+  size_t frame;
+};
+
+using FastTrig::Accuracy;
+
+// Сигнатура ядра: trig — как считать sin/cos(theta)
+using KernelFn = void (*)(const Links& links, const double* thetas_deg, Strides st, size_t samples,
+                          const Output& out, bool tcpOnly, Accuracy trig);
+
+void kernelScalar(const Links&, const double*, Strides, size_t, const Output&, bool, Accuracy);
+void kernelSse2  (const Links&, const double*, Strides, size_t, const Output&, bool, Accuracy);
+void kernelAvx2  (const Links&, const double*, Strides, size_t, const Output&, bool, Accuracy);
+void kernelAvx512(const Links&, const double*, Strides, size_t, const Output&, bool, Accuracy);
+
+namespace {
+
+// Один блок из P::W конфигураций (valid <= W реально заполнены, остальные дорожки — нули).
+// Порядок операций повторяет Core::mul/Core::interpretOne, нули нижней строки опущены —
+// они дают точные +0 и результат не меняют.
+template <class P, Accuracy A>
+inline void runBlock(const Links& L, const double* thetas_deg, Strides str, size_t first, size_t valid,
+                     const Output& out, bool tcpOnly) {
+  using V = typename P::V;
+  constexpr int W = P::W;
+  constexpr double DEG2RAD = 3.14159265358979323846 / 180.0;
+  const size_t dof = L.dof;
+
+  // Накопленная T0->i (только 3 верхние строки: нижняя всегда [0 0 0 1])
+  V c00 = P::set1(1.0), c01 = P::zero(),    c02 = P::zero(),    c03 = P::zero();
+  V c10 = P::zero(),    c11 = P::set1(1.0), c12 = P::zero(),    c13 = P::zero();
+  V c20 = P::zero(),    c21 = P::zero(),    c22 = P::set1(1.0), c23 = P::zero();
+
+  alignas(64) double ctBuf[W];
+  alignas(64) double stBuf[W];
+
+  for (size_t k = 0; k < dof; ++k) {
+    // cos/sin(theta) по дорожкам
+    V ct, st;
+    if constexpr (A == Accuracy::Libm) {
+      for (int l = 0; l < W; ++l) {
+        const double t = (size_t(l) < valid)
+            ? thetas_deg[(first + size_t(l)) * str.sample + k * str.joint] * DEG2RAD : 0.0;
+        ctBuf[l] = std::cos(t);
+        stBuf[l] = std::sin(t);
+      }
+      ct = P::load(ctBuf);
+      st = P::load(stBuf);
+    } else {
+      for (int l = 0; l < W; ++l)
+        ctBuf[l] = (size_t(l) < valid) ? thetas_deg[(first + size_t(l)) * str.sample + k * str.joint] : 0.0;
+      FastTrig::sincosDeg<P, A>(P::load(ctBuf), st, ct);
+    }
+    const V ca = P::set1(L.ca[k]), sa = P::set1(L.sa[k]);
+    const V a  = P::set1(L.a[k]),  d  = P::set1(L.d[k]);
+
+    // Локальная A (как в Core::makeA)
+    const V a00 = ct,                 a01 = P::neg(P::mul(st, ca)), a02 = P::mul(st, sa), a03 = P::mul(a, ct);
+    const V a10 = st,                 a11 = P::mul(ct, ca),         a12 = P::neg(P::mul(ct, sa)), a13 = P::mul(a, st);
+    const V                           a21 = sa,                     a22 = ca;
+
+    // next = C * A
+    auto row = [&](V& r0, V& r1, V& r2, V& r3) {
+      const V n0 = P::add(P::mul(r0, a00), P::mul(r1, a10));
+      const V n1 = P::add(P::add(P::mul(r0, a01), P::mul(r1, a11)), P::mul(r2, a21));
+      const V n2 = P::add(P::add(P::mul(r0, a02), P::mul(r1, a12)), P::mul(r2, a22));
+      const V n3 = P::add(P::add(P::add(P::mul(r0, a03), P::mul(r1, a13)), P::mul(r2, d)), r3);
+      r0 = n0; r1 = n1; r2 = n2; r3 = n3;
+    };
+    row(c00, c01, c02, c03);
+    row(c10, c11, c12, c13);
+    row(c20, c21, c22, c23);
+
+    if (tcpOnly && k + 1 != dof) continue;
+
+    // Запись поля по дорожкам: в SoA (sample == 1) полный блок выровнен — одним store,
+    // иначе через буфер с шагом sample
+    const size_t at = first * out.sample + k * out.frame;
+    auto put = [&](int c, V v) {
+      double* p = out.field[c] + at;
+      if (out.sample == 1 && valid == size_t(W) &&
+          reinterpret_cast<std::uintptr_t>(p) % (sizeof(double) * W) == 0) {
+        P::store(p, v);
+        return;
+      }
+      alignas(64) double lane[W];
+      P::store(lane, v);
+      for (size_t l = 0; l < valid; ++l) p[l * out.sample] = lane[l];
+    };
+    put(0, c03); put(1, c13); put(2, c23);
+    if (!out.field[3]) continue;
+
+    // ---- Интерпретация (как Core::interpretOne) ----
+    V xx = c00, xy = c10, xz = c20;
+    V zx = c02, zy = c12, zz = c22;
+
+    auto norm = [](V& u, V& v, V& w) {
+      const V n = P::sqrt(P::add(P::add(P::mul(u, u), P::mul(v, v)), P::mul(w, w)));
+      const V dv = P::selectGreater(n, 1e-12, n, P::set1(1.0));
+      u = P::div(u, dv); v = P::div(v, dv); w = P::div(w, dv);
+    };
+
+    norm(zx, zy, zz);
+    const V xdz = P::add(P::add(P::mul(xx, zx), P::mul(xy, zy)), P::mul(xz, zz));
+    xx = P::sub(xx, P::mul(xdz, zx));
+    xy = P::sub(xy, P::mul(xdz, zy));
+    xz = P::sub(xz, P::mul(xdz, zz));
+    norm(xx, xy, xz);
+
+    V yx = P::sub(P::mul(zy, xz), P::mul(zz, xy));
+    V yy = P::sub(P::mul(zz, xx), P::mul(zx, xz));
+    V yz = P::sub(P::mul(zx, xy), P::mul(zy, xx));
+    norm(yx, yy, yz);
+
+    put(3, xx);  put(4, xy);  put(5, xz);
+    put(6, yx);  put(7, yy);  put(8, yz);
+    put(9, zx);  put(10, zy); put(11, zz);
+  }
+}
+
+// Полный прогон: целые блоки по W, хвост — тем же блоком с неполными дорожками
+template <class P, Accuracy A>
+inline void runBlocks(const Links& L, const double* thetas_deg, Strides str, size_t samples,
+                      const Output& out, bool tcpOnly) {
+  constexpr size_t W = size_t(P::W);
+  size_t i = 0;
+  for (; i + W <= samples; i += W) runBlock<P, A>(L, thetas_deg, str, i, W, out, tcpOnly);
+  if (i < samples) runBlock<P, A>(L, thetas_deg, str, i, samples - i, out, tcpOnly);
+}
+
+// Точность sin/cos — параметр шаблона: выбор один раз на пакет, не на каждое звено
+template <class P>
+inline void runKernel(const Links& L, const double* thetas_deg, Strides str, size_t samples,
+                      const Output& out, bool tcpOnly, Accuracy trig) {
+  switch (trig) {
+    case Accuracy::PolyFull: runBlocks<P, Accuracy::PolyFull>(L, thetas_deg, str, samples, out, tcpOnly); break;
+    case Accuracy::Poly1e9:  runBlocks<P, Accuracy::Poly1e9> (L, thetas_deg, str, samples, out, tcpOnly); break;
+    case Accuracy::Poly1e6:  runBlocks<P, Accuracy::Poly1e6> (L, thetas_deg, str, samples, out, tcpOnly); break;
+    default:                 runBlocks<P, Accuracy::Libm>    (L, thetas_deg, str, samples, out, tcpOnly); break;
+  }
+}
+
+} // namespace
+} // namespace detail
+} // namespace FkSimd
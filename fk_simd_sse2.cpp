@@ -0,0 +1,30 @@
+// SSE2: 2 конфигурации на регистр. Собирается с -msse2 (на x86-64 это базовый уровень).
+#include "fk_simd_kernel.h"
+#include <emmintrin.h>
+
+namespace {
+struct PackSse2 {
+  using V = __m128d;
+  static constexpr int W = 2;
+  static V zero()                 { return _mm_setzero_pd(); }
+  static V set1(double v)         { return _mm_set1_pd(v); }
+  static V load(const double* p)  { return _mm_load_pd(p); }
+  static void store(double* p, V v) { _mm_store_pd(p, v); }
+  static V add(V a, V b)          { return _mm_add_pd(a, b); }
+  static V sub(V a, V b)          { return _mm_sub_pd(a, b); }
+  static V mul(V a, V b)          { return _mm_mul_pd(a, b); }
+  static V div(V a, V b)          { return _mm_div_pd(a, b); }
+  static V neg(V a)               { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+  static V sqrt(V a)              { return _mm_sqrt_pd(a); }
+  // (x > thr) ? a : b
+  static V selectGreater(V x, double thr, V a, V b) {
+    const V m = _mm_cmpgt_pd(x, _mm_set1_pd(thr));
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+  }
+};
+} // namespace
+
+void FkSimd::detail::kernelSse2(const Links& L, const double* thetas_deg, Strides str, size_t samples,
+                                const Output& out, bool tcpOnly, Accuracy trig) {
+  runKernel<PackSse2>(L, thetas_deg, str, samples, out, tcpOnly, trig);
+}
@@ -0,0 +1,245 @@
+#include "ik.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+constexpr double RAD2DEG = 180.0 / 3.14159265358979323846;
+
+// Ошибка позы: e[0..2] — позиция (м), e[3..5] — ориентация (рад)
+void poseError(const Interp& cur, const Interp& tgt, double e[6]) {
+  e[0] = tgt.x - cur.x;
+  e[1] = tgt.y - cur.y;
+  e[2] = tgt.z - cur.z;
+
+  auto crossAdd = [&](double ax, double ay, double az, double bx, double by, double bz) {
+    e[3] += 0.5 * (ay*bz - az*by);
+    e[4] += 0.5 * (az*bx - ax*bz);
+    e[5] += 0.5 * (ax*by - ay*bx);
+  };
+  e[3] = e[4] = e[5] = 0.0;
+  crossAdd(cur.xx, cur.xy, cur.xz, tgt.xx, tgt.xy, tgt.xz);
+  crossAdd(cur.yx, cur.yy, cur.yz, tgt.yx, tgt.yy, tgt.yz);
+  crossAdd(cur.zx, cur.zy, cur.zz, tgt.zx, tgt.zy, tgt.zz);
+}
+
+// Решить A y = b для симметричной положительно определённой 6x6 (Холецкий, на месте)
+bool solveSpd6(double A[6][6], double b[6]) {
+  for (int j = 0; j < 6; ++j) {
+    double s = A[j][j];
+    for (int k = 0; k < j; ++k) s -= A[j][k] * A[j][k];
+    if (s <= 0.0) return false;
+    const double l = std::sqrt(s);
+    A[j][j] = l;
+    for (int i = j + 1; i < 6; ++i) {
+      double t = A[i][j];
+      for (int k = 0; k < j; ++k) t -= A[i][k] * A[j][k];
+      A[i][j] = t / l;
+    }
+  }
+  // L z = b
+  for (int i = 0; i < 6; ++i) {
+    double t = b[i];
+    for (int k = 0; k < i; ++k) t -= A[i][k] * b[k];
+    b[i] = t / A[i][i];
+  }
+  // L^T y = z
+  for (int i = 5; i >= 0; --i) {
+    double t = b[i];
+    for (int k = i + 1; k < 6; ++k) t -= A[k][i] * b[k];
+    b[i] = t / A[i][i];
+  }
+  return true;
+}
+
+bool hasLimits(const IkOptions& opt, size_t n) {
+  return opt.lowerDeg.size() == n && opt.upperDeg.size() == n;
+}
+
+// Параметры решателя. damping > 0: при lambda = 0 и вырожденном J (особая поза, или
+// orientationWeight = 0 — нулевые строки 3..5) система J J^T + lambda^2 I вырождена.
+// Пределы: оба пусты или оба длины n с lower <= upper (std::clamp и uniform_real_distribution
+// при lower > upper дают неопределённое поведение)
+bool checkOptions(const IkOptions& opt, size_t n, std::string* error) {
+  const double lambda2 = opt.damping * opt.damping;
+  if (!(opt.damping > 0.0 && lambda2 > 0.0 && std::isfinite(lambda2))) {
+    *error = "damping must be positive";
+    return false;
+  }
+  if (opt.lowerDeg.empty() && opt.upperDeg.empty()) return true;
+  if (!hasLimits(opt, n)) {
+    *error = "joint limits must have " + std::to_string(n) + " entries";
+    return false;
+  }
+  for (size_t k = 0; k < n; ++k) {
+    if (!(opt.lowerDeg[k] <= opt.upperDeg[k])) {
+      *error = "bad limits for joint " + std::to_string(k);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Угол в [-180, 180)
+double wrapDeg(double a) {
+  a = std::fmod(a + 180.0, 360.0);
+  if (a < 0.0) a += 360.0;
+  return a - 180.0;
+}
+
+// Лучше ли a, чем b: сошедшееся важнее, затем суммарная ошибка
+bool better(const IkResult& a, const IkResult& b) {
+  if (a.converged != b.converged) return a.converged;
+  return (a.posError + a.rotError) < (b.posError + b.rotError);
+}
+} // namespace
+
+IkResult IkSolver::run(const Interp& target, const double* seed_deg, const IkOptions& opt,
+                       const std::atomic<bool>* stop) const {
+  const size_t n = jac_.dof();
+  IkResult res;
+  res.theta_deg.assign(seed_deg, seed_deg + n);
+  if (n == 0) return res;
+  if (!checkOptions(opt, n, &res.error)) return res;
+
+  const bool limits = hasLimits(opt, n);
+  const double w = std::max(0.0, opt.orientationWeight);
+  const double lambda2 = opt.damping * opt.damping;
+  const double maxStep = opt.maxStepDeg / RAD2DEG;
+
+  Results frames;
+  std::vector<double> J;
+  std::vector<double> dq(n);
+
+  for (int it = 0;; ++it) {
+    jac_.compute(res.theta_deg.data(), frames, J);
+
+    double e[6];
+    poseError(frames.back(), target, e);
+    res.posError = std::sqrt(e[0]*e[0] + e[1]*e[1] + e[2]*e[2]);
+    res.rotError = std::sqrt(e[3]*e[3] + e[4]*e[4] + e[5]*e[5]);
+    res.iterations = it;
+
+    res.converged = res.posError <= opt.posTolerance &&
+                    (w == 0.0 || res.rotError <= opt.rotTolerance);
+    if (res.converged || it >= opt.maxIterations) break;
+    if (stop && stop->load(std::memory_order_relaxed)) break;
+
+    // Вес ориентации: строки 3..5 якобиана и ошибки
+    for (int r = 3; r < 6; ++r) e[r] *= w;
+    for (size_t k = 0; k < n; ++k)
+      for (int r = 3; r < 6; ++r) J[k*6 + r] *= w;
+
+    // A = J J^T + lambda^2 I
+    double A[6][6];
+    for (int r = 0; r < 6; ++r) {
+      for (int c = 0; c <= r; ++c) {
+        double s = 0.0;
+        for (size_t k = 0; k < n; ++k) s += J[k*6 + r] * J[k*6 + c];
+        A[r][c] = A[c][r] = s;
+      }
+      A[r][r] += lambda2;
+    }
+    // lambda^2 > 0 проверен в checkOptions; отказ возможен, лишь если lambda^2 теряется в
+    // округлении J J^T — тогда остаётся последнее приближение (converged = false)
+    if (!solveSpd6(A, e)) break;
+
+    // dq = J^T y, с ограничением шага
+    for (size_t k = 0; k < n; ++k) {
+      double s = 0.0;
+      for (int r = 0; r < 6; ++r) s += J[k*6 + r] * e[r];
+      dq[k] = std::clamp(s, -maxStep, maxStep);
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+      double t = res.theta_deg[k] + dq[k] * RAD2DEG;
+      if (limits) t = std::clamp(t, opt.lowerDeg[k], opt.upperDeg[k]);
+      res.theta_deg[k] = t;
+    }
+  }
+
+  if (!limits)
+    for (auto& t : res.theta_deg) t = wrapDeg(t);
+
+  res.totalIterations = res.iterations;
+  res.seedsTried = 1;
+  return res;
+}
+
+IkResult IkSolver::solve(const Interp& target, const double* seed_deg, const IkOptions& opt) const {
+  const auto t0 = std::chrono::steady_clock::now();
+  IkResult res = run(target, seed_deg, opt, nullptr);
+  res.seedIndex = 0;
+  res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return res;
+}
+
+IkResult IkSolver::solveMultiSeed(const Interp& target, const IkOptions& opt,
+                                  const double* warmStart) const {
+  const auto t0 = std::chrono::steady_clock::now();
+  const size_t n = jac_.dof();
+  {
+    IkResult bad;
+    if (!checkOptions(opt, n, &bad.error)) return bad;
+  }
+  const int total = std::max(1, opt.seeds);
+
+  int threads = opt.threads > 0 ? opt.threads : static_cast<int>(std::thread::hardware_concurrency());
+  threads = std::clamp(threads, 1, total);
+
+  const bool limits = hasLimits(opt, n);
+
+  std::atomic<int>  next{0};
+  std::atomic<bool> stop{false};
+  std::mutex m;
+  IkResult best;
+  int tried = 0, iters = 0;
+
+  auto worker = [&] {
+    std::vector<double> seed(n);
+    for (;;) {
+      if (stop.load(std::memory_order_relaxed)) break;
+      const int k = next.fetch_add(1);
+      if (k >= total) break;
+
+      // Старт k: детерминирован по (rngSeed, k), не зависит от распределения по потокам
+      if (k == 0 && warmStart) {
+        seed.assign(warmStart, warmStart + n);
+      } else {
+        std::mt19937_64 rng(opt.rngSeed * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(k));
+        for (size_t j = 0; j < n; ++j) {
+          const double lo = limits ? opt.lowerDeg[j] : -180.0;
+          const double hi = limits ? opt.upperDeg[j] :  180.0;
+          seed[j] = std::uniform_real_distribution<double>(lo, hi)(rng);
+        }
+      }
+
+      IkResult r = run(target, seed.data(), opt,
+                       opt.mode == IkOptions::Mode::First ? &stop : nullptr);
+      r.seedIndex = k;
+
+      std::lock_guard<std::mutex> lock(m);
+      ++tried;
+      iters += r.iterations;
+      if (best.seedIndex < 0 || better(r, best) ||
+          (!better(best, r) && r.seedIndex < best.seedIndex)) {
+        best = std::move(r);
+      }
+      if (best.converged && opt.mode == IkOptions::Mode::First) stop.store(true);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(static_cast<size_t>(threads - 1));
+  for (int t = 1; t < threads; ++t) pool.emplace_back(worker);
+  worker();
+  for (auto& th : pool) th.join();
+
+  best.seedsTried = tried;
+  best.totalIterations = iters;
+  best.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return best;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "jacobian.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Численная обратная кинематика: демпфированные наименьшие квадраты (DLS)
+//   dq = J^T (J J^T + lambda^2 I)^-1 e
+// Цель — поза TCP в том же виде, что отдаёт Core: позиция + орто-нормированный базис (Interp).
+// Ошибка ориентации — 0.5 * sum(a_cur x a_target) по трём осям.
+
+struct IkOptions {
+  int    maxIterations   = 200;     // на одно начальное приближение
+  double damping         = 0.05;    // lambda > 0; иначе отказ (IkResult::error)
+  double posTolerance    = 1e-6;    // м
+  double rotTolerance    = 1e-6;    // рад
+  double orientationWeight = 1.0;   // 0 — решать только по позиции
+  double maxStepDeg      = 20.0;    // ограничение шага по каждому суставу за итерацию
+
+  // Пределы суставов (градусы). Пусто — без ограничений, случайные старты в [-180, 180].
+  // Иначе оба вектора длины dof и lower <= upper, без NaN; неверные пределы — отказ (IkResult::error).
+  std::vector<double> lowerDeg;
+  std::vector<double> upperDeg;
+
+  // Мультистарт
+  enum class Mode { First, Best };
+  Mode     mode    = Mode::First;   // First — первое сошедшееся; Best — лучшее из всех стартов
+  int      seeds   = 64;            // сколько стартов всего (включая warm start)
+  int      threads = 0;             // 0 — по числу ядер
+  uint64_t rngSeed = 1;             // детерминированная генерация стартов
+};
+
+struct IkResult {
+  bool   converged = false;
+  std::vector<double> theta_deg;    // решение (или лучшее найденное)
+  int    iterations = 0;            // итераций у выбранного старта
+  int    totalIterations = 0;       // сумма по всем запущенным стартам
+  double posError = 0.0;            // м
+  double rotError = 0.0;            // рад
+  int    seedIndex = -1;            // какой старт дал решение (0 — warm start, если был)
+  int    seedsTried = 0;
+  double seconds = 0.0;             // время решения (стена)
+  std::string error;                // не пусто — решение не запускалось (неверные параметры)
+};
+
+class IkSolver {
+public:
+  IkSolver() = default;
+  explicit IkSolver(const Snapshot& chain) : jac_(chain) {}
+
+  size_t dof() const { return jac_.dof(); }
+
+  // Один старт из seed_deg (warm start, например — решение на прошлом такте)
+  IkResult solve(const Interp& target, const double* seed_deg, const IkOptions& opt = {}) const;
+
+  // Много стартов параллельно по ядрам. warmStart (если задан) — старт №0,
+  // остальные — случайные в пределах суставов.
+  IkResult solveMultiSeed(const Interp& target, const IkOptions& opt = {},
+                          const double* warmStart = nullptr) const;
+
+private:
+  // Внутренний прогон одного старта; stop — досрочная остановка (режим First)
+  IkResult run(const Interp& target, const double* seed_deg, const IkOptions& opt,
+               const std::atomic<bool>* stop) const;
+
+  JacobianEngine jac_;
+};
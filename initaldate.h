@@ -11,16 +11,24 @@ struct JointDH {
 // Динамический снимок: количество строк таблицы может меняться
 using Snapshot = std::vector<JointDH>;
 
-// Интерпретированные данные для каждого звена: позиция + полный ортонормированный базис (X,Y,Z) в мировой СК
-struct Interp {
+// Интерпретированные данные для каждого звена: позиция + полный ортонормированный базис (X,Y,Z) в мировой СК.
+// Scalar — double (эталон, UI) или float (рендер/выборки, см. CoreF в core.h)
+template <class Scalar>
+struct InterpT {
   // Позиция начала кадра звена i в базовой СК
-  double x, y, z;
+  Scalar x, y, z;
 
   // Оси кадра звена i в базовой СК (единичные векторы, правый базис)
-  double xx, xy, xz;  // ось X_i
-  double yx, yy, yz;  // ось Y_i
-  double zx, zy, zz;  // ось Z_i
+  Scalar xx, xy, xz;  // ось X_i
+  Scalar yx, yy, yz;  // ось Y_i
+  Scalar zx, zy, zz;  // ось Z_i
 };
 
-using Results = std::vector<Interp>;
+using Interp  = InterpT<double>;
+using InterpF = InterpT<float>;
 
+template <class Scalar>
+using ResultsT = std::vector<InterpT<Scalar>>;
+
+using Results  = ResultsT<double>;
+using ResultsF = ResultsT<float>;
@@ -0,0 +1,260 @@
+#include "instanced_cylinders.h"
+
+#include <Qt3DExtras/QCylinderGeometry>
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QGraphicsApiFilter>
+#include <Qt3DRender/QParameter>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QShaderProgram>
+#include <Qt3DRender/QTechnique>
+#include <QByteArray>
+#include <QQuaternion>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr float kPi = 3.14159265358979323846f;
+
+QQuaternion rotationFromYTo(const QVector3D& dir) {
+  // Базовый цилиндр ориентирован вдоль +Y (0,1,0)
+  static const QVector3D up(0.f, 1.f, 0.f);
+  QVector3D d = dir.normalized();
+
+  const float dot = QVector3D::dotProduct(up, d);
+  if (dot > 0.9999f) return QQuaternion();
+  if (dot < -0.9999f) {
+    // Противоположные направления: поворот на 180° вокруг любой оси, ортогональной up
+    return QQuaternion::fromAxisAndAngle(QVector3D(1,0,0), 180.0f);
+  }
+  const QVector3D axis = QVector3D::crossProduct(up, d).normalized();
+  const float angleDeg = std::acos(std::clamp(dot, -1.0f, 1.0f)) * 180.0f / kPi;
+  return QQuaternion::fromAxisAndAngle(axis, angleDeg);
+}
+
+// --- OpenGL 3.2+ (Qt 5 и OpenGL-рендерер Qt 6; RHI-техники нет) ---
+
+const char* kVertGl = R"(#version 150 core
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec4 instanceModel0;
+in vec4 instanceModel1;
+in vec4 instanceModel2;
+in vec4 instanceModel3;
+in vec4 instanceColor;
+
+out vec3 worldPosition;
+out vec3 worldNormal;
+out vec4 color;
+
+uniform mat4 modelMatrix;
+uniform mat4 viewProjectionMatrix;
+
+void main() {
+  mat4 inst = mat4(instanceModel0, instanceModel1, instanceModel2, instanceModel3);
+  // inst = R * S: нормаль преобразуется как R * S^-1 = inst * S^-2
+  vec3 s2 = vec3(dot(inst[0].xyz, inst[0].xyz), dot(inst[1].xyz, inst[1].xyz), dot(inst[2].xyz, inst[2].xyz));
+  vec3 n = mat3(inst) * (vertexNormal / max(s2, vec3(1e-12)));
+  vec4 world = modelMatrix * inst * vec4(vertexPosition, 1.0);
+  worldPosition = world.xyz;
+  worldNormal = mat3(modelMatrix) * n;
+  color = instanceColor;
+  gl_Position = viewProjectionMatrix * world;
+}
+)";
+
+const char* kFragGl = R"(#version 150 core
+in vec3 worldPosition;
+in vec3 worldNormal;
+in vec4 color;
+out vec4 fragColor;
+
+uniform vec3 eyePosition;
+uniform vec3 lightPosition;
+uniform float lightIntensity;
+
+void main() {
+  vec3 n = normalize(worldNormal);
+  vec3 l = normalize(lightPosition - worldPosition);
+  vec3 v = normalize(eyePosition - worldPosition);
+  float diff = max(dot(n, l), 0.0);
+  float spec = diff > 0.0 ? pow(max(dot(reflect(-l, n), v), 0.0), 150.0) : 0.0;
+  // Как у QPhongMaterial по умолчанию: ambient 0.05, specular 0.01, shininess 150
+  vec3 c = color.rgb * (0.05 + diff * lightIntensity) + vec3(0.01 * spec * lightIntensity);
+  fragColor = vec4(clamp(c, 0.0, 1.0), color.a);
+}
+)";
+
+
+Qt3DRender::QTechnique* makeTechnique(const char* vert, const char* frag) {
+  auto* technique = new Qt3DRender::QTechnique();
+  technique->graphicsApiFilter()->setApi(Qt3DRender::QGraphicsApiFilter::OpenGL);
+  technique->graphicsApiFilter()->setMajorVersion(3);
+  technique->graphicsApiFilter()->setMinorVersion(2);
+  technique->graphicsApiFilter()->setProfile(Qt3DRender::QGraphicsApiFilter::CoreProfile);
+
+  // Ключ, по которому QForwardRenderer выбирает техники
+  auto* style = new Qt3DRender::QFilterKey(technique);
+  style->setName(QStringLiteral("renderingStyle"));
+  style->setValue(QStringLiteral("forward"));
+  technique->addFilterKey(style);
+
+  auto* program = new Qt3DRender::QShaderProgram(technique);
+  program->setVertexShaderCode(QByteArray(vert));
+  program->setFragmentShaderCode(QByteArray(frag));
+
+  auto* pass = new Qt3DRender::QRenderPass(technique);
+  pass->setShaderProgram(program);
+  technique->addRenderPass(pass);
+  return technique;
+}
+
+} // namespace
+
+InstancedCylinders::InstancedCylinders(Qt3DCore::QNode* parent) : Qt3DCore::QEntity(parent) {
+  // Единичный цилиндр вдоль +Y: та же сетка, что у QCylinderMesh (rings 16, slices 24)
+  auto* geometry = new Qt3DExtras::QCylinderGeometry(this);
+  geometry->setLength(1.0f);
+  geometry->setRadius(1.0f);
+  geometry->setRings(16);
+  geometry->setSlices(24);
+
+  buffer_ = new Qt3DGeometry::QBuffer(geometry);
+
+  static const char* names[5] = {
+    "instanceModel0", "instanceModel1", "instanceModel2", "instanceModel3", "instanceColor"
+  };
+  for (int k = 0; k < 5; ++k) {
+    auto* a = new Qt3DGeometry::QAttribute(geometry);
+    a->setName(QString::fromLatin1(names[k]));
+    a->setAttributeType(Qt3DGeometry::QAttribute::VertexAttribute);
+    a->setVertexBaseType(Qt3DGeometry::QAttribute::Float);
+    a->setVertexSize(4);
+    a->setByteOffset(uint(k * 4 * sizeof(float)));
+    a->setByteStride(uint(kFloatsPerInstance * sizeof(float)));
+    a->setDivisor(1);
+    a->setCount(0);
+    a->setBuffer(buffer_);
+    geometry->addAttribute(a);
+    attrs_[k] = a;
+  }
+
+  // Объём для отсечения: две вершины (min, max) вместо позиций сетки единичного цилиндра
+  boundsBuffer_ = new Qt3DGeometry::QBuffer(geometry);
+  boundsBuffer_->setData(QByteArray(reinterpret_cast<const char*>(bounds_), int(sizeof(bounds_))));
+  auto* bounds = new Qt3DGeometry::QAttribute(geometry);
+  bounds->setName(QStringLiteral("instanceBounds"));
+  bounds->setAttributeType(Qt3DGeometry::QAttribute::VertexAttribute);
+  bounds->setVertexBaseType(Qt3DGeometry::QAttribute::Float);
+  bounds->setVertexSize(3);
+  bounds->setByteStride(uint(3 * sizeof(float)));
+  bounds->setCount(2);
+  bounds->setBuffer(boundsBuffer_);
+  geometry->addAttribute(bounds);
+  geometry->setBoundingVolumePositionAttribute(bounds);
+
+  renderer_ = new Qt3DRender::QGeometryRenderer(this);
+  renderer_->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
+  renderer_->setGeometry(geometry);
+  renderer_->setInstanceCount(0);
+
+  addComponent(renderer_);
+  addComponent(makeMaterial());
+  setEnabled(false);   // пока нет экземпляров
+}
+
+Qt3DRender::QMaterial* InstancedCylinders::makeMaterial() {
+  auto* material = new Qt3DRender::QMaterial(this);
+  auto* effect = new Qt3DRender::QEffect(material);
+
+  effect->addTechnique(makeTechnique(kVertGl, kFragGl));
+
+  lightPos_ = new Qt3DRender::QParameter(QStringLiteral("lightPosition"), QVector3D(10.f, 12.f, 10.f), material);
+  lightIntensity_ = new Qt3DRender::QParameter(QStringLiteral("lightIntensity"), 1.0f, material);
+  material->addParameter(lightPos_);
+  material->addParameter(lightIntensity_);
+
+  material->setEffect(effect);
+  return material;
+}
+
+void InstancedCylinders::setLight(const QVector3D& position, float intensity) {
+  lightPos_->setValue(position);
+  lightIntensity_->setValue(intensity);
+}
+
+void InstancedCylinders::resize(size_t count) {
+  if (count == count_) return;
+  data_.resize(count * kFloatsPerInstance, 0.0f);   // нули — скрытые экземпляры
+  count_ = count;
+  dirty_ = true;
+}
+
+bool InstancedCylinders::modelMatrix(const QVector3D& origin, const QVector3D& dir, float length,
+                                     float radius, QMatrix4x4& m) {
+  QVector3D d = dir;
+  if (d.lengthSquared() < 1e-12f || length <= 0.f) return false;
+  d.normalize();
+
+  // Масштаб (r, L, r), поворот +Y -> d, центр в середине отрезка
+  m.setToIdentity();
+  m.translate(origin + d * (length * 0.5f));
+  m.rotate(rotationFromYTo(d));
+  m.scale(radius, length, radius);
+  return true;
+}
+
+void InstancedCylinders::set(size_t slot, const QVector3D& origin, const QVector3D& dir,
+                             float length, float radius, const QColor& color) {
+  if (slot >= count_) return;
+  QMatrix4x4 m;
+  if (!modelMatrix(origin, dir, length, radius, m)) { hide(slot); return; }
+
+  float* out = data_.data() + slot * kFloatsPerInstance;
+  std::memcpy(out, m.constData(), 16 * sizeof(float));   // по столбцам, как mat4 в GLSL
+  out[16] = float(color.redF());
+  out[17] = float(color.greenF());
+  out[18] = float(color.blueF());
+  out[19] = float(color.alphaF());
+  dirty_ = true;
+}
+
+void InstancedCylinders::hide(size_t slot) {
+  if (slot >= count_) return;
+  float* out = data_.data() + slot * kFloatsPerInstance;
+  std::fill(out, out + kFloatsPerInstance, 0.0f);
+  dirty_ = true;
+}
+
+void InstancedCylinders::upload() {
+  if (!dirty_) return;
+  dirty_ = false;
+
+  buffer_->setData(QByteArray(reinterpret_cast<const char*>(data_.data()),
+                              int(data_.size() * sizeof(float))));
+  for (auto* a : attrs_) a->setCount(uint(count_));
+  renderer_->setInstanceCount(int(count_));
+  setEnabled(count_ > 0);
+
+  // Коробка видимых экземпляров: единичный цилиндр лежит в [-1,1] x [-0.5,0.5] x [-1,1],
+  // полуразмер по оси i после матрицы — |m0_i| + 0.5 |m1_i| + |m2_i| (столбцы m0..m2)
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  float box[6] = { inf, inf, inf, -inf, -inf, -inf };
+  for (size_t slot = 0; slot < count_; ++slot) {
+    const float* m = data_.data() + slot * kFloatsPerInstance;
+    if (m[15] == 0.0f) continue;   // скрытый
+    for (int i = 0; i < 3; ++i) {
+      const float half = std::fabs(m[i]) + 0.5f * std::fabs(m[4 + i]) + std::fabs(m[8 + i]);
+      box[i]     = std::min(box[i],     m[12 + i] - half);
+      box[3 + i] = std::max(box[3 + i], m[12 + i] + half);
+    }
+  }
+  if (box[0] > box[3]) std::fill(box, box + 6, 0.0f);   // видимых нет
+  if (std::memcmp(box, bounds_, sizeof(box)) != 0) {
+    std::memcpy(bounds_, box, sizeof(box));
+    boundsBuffer_->setData(QByteArray(reinterpret_cast<const char*>(bounds_), int(sizeof(bounds_))));
+  }
+}
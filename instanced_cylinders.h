@@ -0,0 +1,76 @@
+#pragma once
+#include <QColor>
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QtGlobal>
+#include <vector>
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DRender/QGeometryRenderer>
+#include <Qt3DRender/QMaterial>
+#include <Qt3DRender/QParameter>
+
+// QBuffer/QAttribute/QGeometry переехали из Qt3DRender (Qt 5) в Qt3DCore (Qt 6)
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+#include <Qt3DCore/QAttribute>
+#include <Qt3DCore/QBuffer>
+namespace Qt3DGeometry = Qt3DCore;
+#else
+#include <Qt3DRender/QAttribute>
+#include <Qt3DRender/QBuffer>
+namespace Qt3DGeometry = Qt3DRender;
+#endif
+
+// Набор цилиндров одним инстансированным вызовом отрисовки.
+// Геометрия — единичный цилиндр вдоль +Y (длина 1, радиус 1), на экземпляр — матрица модели
+// (поворот + масштаб (r, L, r) + перенос) и цвет RGBA: 20 float в одном вершинном буфере
+// с делителем 1. set/hide пишут только в копию на CPU, upload отправляет весь буфер
+// одним QBuffer::setData — то есть не больше одной записи в буфер на кадр.
+// Скрытый экземпляр — нулевая матрица (вырожденные треугольники не растеризуются).
+//
+// Ограничивающий объём сущности (для отсечения по пирамиде видимости) — коробка всех видимых
+// экземпляров, а не сетка единичного цилиндра: отдельный атрибут из двух вершин (min, max),
+// upload переписывает его, только когда коробка изменилась.
+//
+// Освещение — Фонг от одного точечного источника (параметры light*), как у QPhongMaterial.
+// Техника одна — GLSL 150 под OpenGL-рендерер Qt3D; под RHI (Qt 6) Render3D рисует цилиндры
+// отдельными сущностями с той же матрицей (modelMatrix).
+class InstancedCylinders : public Qt3DCore::QEntity {
+public:
+  static constexpr int kFloatsPerInstance = 20;   // 4 столбца матрицы + цвет
+
+  explicit InstancedCylinders(Qt3DCore::QNode* parent = nullptr);
+
+  // Число экземпляров; новые скрыты, существующие сохраняются
+  void resize(size_t count);
+  size_t size() const { return count_; }
+
+  // Цилиндр от origin вдоль dir длиной length. Нулевые dir/length — скрыть
+  void set(size_t slot, const QVector3D& origin, const QVector3D& dir,
+           float length, float radius, const QColor& color);
+  void hide(size_t slot);
+
+  // Отправить изменённые экземпляры на GPU (ничего не делает, если изменений не было)
+  void upload();
+
+  void setLight(const QVector3D& position, float intensity);
+
+  // Матрица единичного цилиндра для отрезка (как у экземпляра); false — нулевые dir/length
+  static bool modelMatrix(const QVector3D& origin, const QVector3D& dir, float length, float radius,
+                          QMatrix4x4& m);
+
+private:
+  Qt3DRender::QMaterial* makeMaterial();
+
+  std::vector<float> data_;   // count_ * kFloatsPerInstance
+  size_t count_ = 0;
+  bool dirty_ = false;
+
+  Qt3DGeometry::QBuffer*     buffer_   = nullptr;
+  Qt3DGeometry::QAttribute*  attrs_[5] = {};       // instanceModel0..3, instanceColor
+  Qt3DGeometry::QBuffer*     boundsBuffer_ = nullptr;
+  float bounds_[6] = {};                           // min xyz, max xyz — последние отправленные
+  Qt3DRender::QGeometryRenderer* renderer_ = nullptr;
+  Qt3DRender::QParameter*    lightPos_ = nullptr;
+  Qt3DRender::QParameter*    lightIntensity_ = nullptr;
+};
@@ -0,0 +1,63 @@
+#include "jacobian.h"
+#include <algorithm>
+
+void JacobianEngine::fromFrames(const Interp* frames, size_t dof, size_t target, double* J) {
+  const Interp& e = frames[target];
+
+  for (size_t k = 0; k < dof; ++k) {
+    double* col = J + k * 6;
+    if (k > target) {
+      std::fill(col, col + 6, 0.0);
+      continue;
+    }
+
+    // Ось и начало сустава k: кадр k-1, для первого сустава — база
+    double zx = 0.0, zy = 0.0, zz = 1.0;
+    double px = 0.0, py = 0.0, pz = 0.0;
+    if (k > 0) {
+      const Interp& f = frames[k - 1];
+      zx = f.zx; zy = f.zy; zz = f.zz;
+      px = f.x;  py = f.y;  pz = f.z;
+    }
+
+    // J_v = z x (p_target - p)
+    const double rx = e.x - px, ry = e.y - py, rz = e.z - pz;
+    col[0] = zy*rz - zz*ry;
+    col[1] = zz*rx - zx*rz;
+    col[2] = zx*ry - zy*rx;
+
+    // J_w = z
+    col[3] = zx; col[4] = zy; col[5] = zz;
+  }
+}
+
+void JacobianEngine::compute(const double* theta_deg, Results& frames, std::vector<double>& J) const {
+  const size_t n = chain_.dof();
+  chain_.compute(theta_deg, frames);
+  J.resize(n * 6);
+  if (n == 0) return;
+  fromFrames(frames.data(), n, n - 1, J.data());
+}
+
+void JacobianEngine::computeAll(const double* theta_deg, Results& frames, std::vector<double>& Jall) const {
+  const size_t n = chain_.dof();
+  chain_.compute(theta_deg, frames);
+  Jall.resize(n * n * 6);
+  for (size_t j = 0; j < n; ++j) fromFrames(frames.data(), n, j, Jall.data() + j * n * 6);
+}
+
+void JacobianEngine::computeBatch(const double* thetas_deg, size_t samples,
+                                  std::vector<double>& J, Results* tcp) const {
+  const size_t n = chain_.dof();
+  J.resize(samples * n * 6);
+  if (tcp) tcp->resize(n ? samples : 0);
+  if (n == 0 || samples == 0 || !thetas_deg) return;
+
+  // Кадры одной выборки — общий буфер на весь пакет
+  Results frames(n);
+  for (size_t i = 0; i < samples; ++i) {
+    chain_.compute(thetas_deg + i * n, frames.data());
+    fromFrames(frames.data(), n, n - 1, J.data() + i * n * 6);
+    if (tcp) (*tcp)[i] = frames[n - 1];
+  }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "compiled_chain.h"
+#include <vector>
+
+// Геометрический якобиан цепи из вращательных суставов (классический DH).
+// Сустав k вращает вокруг оси z_{k-1} с началом p_{k-1} (для k = 0 — базовая ось Z через (0,0,0)),
+// поэтому столбец k для кадра j (k <= j):
+//   J_v = z_{k-1} x (p_j - p_{k-1}),   J_w = z_{k-1};   при k > j столбец нулевой.
+// Всё берётся из уже посчитанных Interp (позиция + ось Z), второго обхода цепи нет.
+//
+// Раскладка: 6 x dof по столбцам, J[k*6 + r]; r = 0..2 — линейная скорость (м/рад),
+// r = 3..5 — угловая (рад/рад). Производная берётся по theta в радианах,
+// хотя сами углы, как и везде, задаются в градусах.
+class JacobianEngine {
+public:
+  JacobianEngine() = default;
+  explicit JacobianEngine(const Snapshot& s) : chain_(s) {}
+  explicit JacobianEngine(const CompiledChain& chain) : chain_(chain) {}
+
+  size_t dof() const { return chain_.dof(); }
+  const CompiledChain& chain() const { return chain_; }
+
+  // FK + якобиан TCP: frames — dof кадров, J — 6*dof
+  void compute(const double* theta_deg, Results& frames, std::vector<double>& J) const;
+
+  // FK + якобианы всех кадров: Jall — dof блоков по 6*dof, блок j — якобиан кадра j
+  void computeAll(const double* theta_deg, Results& frames, std::vector<double>& Jall) const;
+
+  // Пакет: thetas_deg — N x dof построчно; J — N блоков по 6*dof (якобиан TCP).
+  // tcp (если задан) — N кадров TCP из того же прохода.
+  void computeBatch(const double* thetas_deg, size_t samples,
+                    std::vector<double>& J, Results* tcp = nullptr) const;
+
+  // Якобиан кадра target по готовым кадрам frames[0..dof) в J (6*dof значений)
+  static void fromFrames(const Interp* frames, size_t dof, size_t target, double* J);
+
+private:
+  CompiledChain chain_;
+};
@@ -1,5 +1,7 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include <QFileDialog>
+#include <QSignalBlocker>
 
 MainWindow::MainWindow(QWidget *parent)
   : QMainWindow(parent),
@@ -71,6 +73,32 @@ MainWindow::MainWindow(QWidget *parent)
     app_->onDefaultClicked(ui->inputTable);
   });
 
+  // --- Воспроизведение траектории: управление -> App, кадры -> ползунок и LCD
+  connect(ui->trajectoryBtn, &QPushButton::clicked, this, [this]{
+    const QString path = QFileDialog::getOpenFileName(this, QStringLiteral("Траектория"), QString(),
+                                                      QStringLiteral("Траектории (*.rdht)"));
+    if (path.isEmpty()) return;
+    if (!app_->loadTrajectory(path, ui->sampleRateSpin->value(), ui->inputTable)) return;
+    ui->scrubSlider->setRange(0, int(app_->trajectorySamples()) - 1);
+    ui->scrubSlider->setEnabled(true);
+    ui->playBtn->setEnabled(true);
+  });
+  connect(ui->playBtn,     &QPushButton::clicked, app_.get(), &App::onPlayPauseClicked);
+  connect(ui->scrubSlider, &QSlider::valueChanged, app_.get(), &App::onScrub);
+  connect(ui->loopCheck,   &QCheckBox::toggled,    app_.get(), &App::onLoopToggled);
+  connect(ui->speedSpin, QOverload<double>::of(&QDoubleSpinBox::valueChanged), app_.get(), &App::onSpeedChanged);
+  connect(ui->frameRateSpin, QOverload<int>::of(&QSpinBox::valueChanged), app_.get(), &App::onFrameRateChanged);
+  app_->onFrameRateChanged(ui->frameRateSpin->value());
+
+  connect(app_.get(), &App::playbackStateChanged, this, [this](bool playing){
+    ui->playBtn->setText(playing ? QStringLiteral("Пауза") : QStringLiteral("Пуск"));
+  });
+  connect(app_.get(), &App::playbackFrameShown, this, [this](int sample){
+    const QSignalBlocker block(ui->scrubSlider);   // не превращать показ кадра в перемотку
+    ui->scrubSlider->setValue(sample);
+    visual_.updateLCDs(ui->xLcd, ui->yLcd, ui->zLcd);
+  });
+
 
 }
 
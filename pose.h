@@ -0,0 +1,101 @@
+#pragma once
+#include "initaldate.h"
+#include "fixed_chain.h"
+#include <cmath>
+#include <vector>
+
+// Компактная поза кадра: позиция + единичный кватернион (7 значений вместо 12 у Interp).
+// Для записи длинных траекторий: кадр не нормируется на каждом шаге, как в interpretOne, —
+// кватернион снимается с накопленной матрицы одним sqrt (метод Шеппарда), а нормировка —
+// по запросу (normalize) или периодически по ходу цепи (CompiledChain::computePoses).
+//
+// Кватернион (qw, qx, qy, qz) задаёт поворот базовой СК в СК кадра: оси кадра — столбцы
+// матрицы поворота, как X/Y/Z в Interp. Знак выбран так, что qw >= 0 (q и -q — один поворот).
+template <class Scalar>
+struct PoseT {
+  Scalar x, y, z;          // позиция, метры
+  Scalar qw, qx, qy, qz;   // ориентация
+};
+
+using Pose  = PoseT<double>;
+using PoseF = PoseT<float>;
+
+template <class Scalar>
+using PosesT = std::vector<PoseT<Scalar>>;
+
+using Poses  = PosesT<double>;
+using PosesF = PosesT<float>;
+
+namespace PoseMath {
+
+// Поза из накопленной T0->i без ортонормировки (для ортонормированной R |q| = 1 с точностью
+// округления; дрейф длинной цепи — FixedDH::reorthonormalize или normalize ниже)
+inline Pose fromAffine(const FixedDH::Affine& C) {
+  const double m00 = C.m[0][0], m01 = C.m[0][1], m02 = C.m[0][2];
+  const double m10 = C.m[1][0], m11 = C.m[1][1], m12 = C.m[1][2];
+  const double m20 = C.m[2][0], m21 = C.m[2][1], m22 = C.m[2][2];
+
+  Pose p;
+  p.x = C.m[0][3]; p.y = C.m[1][3]; p.z = C.m[2][3];
+
+  // Шеппард: делим на наибольшую из 4 компонент — без потери точности около 180°
+  const double tr = m00 + m11 + m22;
+  if (tr > 0.0) {
+    const double s = 2.0 * std::sqrt(tr + 1.0), inv = 1.0 / s;
+    p.qw = 0.25 * s;
+    p.qx = (m21 - m12) * inv; p.qy = (m02 - m20) * inv; p.qz = (m10 - m01) * inv;
+  } else if (m00 > m11 && m00 > m22) {
+    const double s = 2.0 * std::sqrt(1.0 + m00 - m11 - m22), inv = 1.0 / s;
+    p.qw = (m21 - m12) * inv;
+    p.qx = 0.25 * s; p.qy = (m01 + m10) * inv; p.qz = (m02 + m20) * inv;
+  } else if (m11 > m22) {
+    const double s = 2.0 * std::sqrt(1.0 + m11 - m00 - m22), inv = 1.0 / s;
+    p.qw = (m02 - m20) * inv;
+    p.qx = (m01 + m10) * inv; p.qy = 0.25 * s; p.qz = (m12 + m21) * inv;
+  } else {
+    const double s = 2.0 * std::sqrt(1.0 + m22 - m00 - m11), inv = 1.0 / s;
+    p.qw = (m10 - m01) * inv;
+    p.qx = (m02 + m20) * inv; p.qy = (m12 + m21) * inv; p.qz = 0.25 * s;
+  }
+  if (p.qw < 0.0) { p.qw = -p.qw; p.qx = -p.qx; p.qy = -p.qy; p.qz = -p.qz; }
+  return p;
+}
+
+// Поза из Interp (адаптер к существующим Results)
+inline Pose fromInterp(const Interp& f) {
+  FixedDH::Affine C{{ { f.xx, f.yx, f.zx, f.x },
+                      { f.xy, f.yy, f.zy, f.y },
+                      { f.xz, f.yz, f.zz, f.z } }};
+  return fromAffine(C);
+}
+
+// Interp из позы: оси — столбцы матрицы поворота кватерниона
+template <class Scalar>
+inline Interp toInterp(const PoseT<Scalar>& p) {
+  const double w = p.qw, x = p.qx, y = p.qy, z = p.qz;
+  Interp f{};
+  f.x = p.x; f.y = p.y; f.z = p.z;
+  f.xx = 1.0 - 2.0*(y*y + z*z); f.xy = 2.0*(x*y + z*w);       f.xz = 2.0*(x*z - y*w);
+  f.yx = 2.0*(x*y - z*w);       f.yy = 1.0 - 2.0*(x*x + z*z); f.yz = 2.0*(y*z + x*w);
+  f.zx = 2.0*(x*z + y*w);       f.zy = 2.0*(y*z - x*w);       f.zz = 1.0 - 2.0*(x*x + y*y);
+  return f;
+}
+
+// Нормировка по запросу
+template <class Scalar>
+inline void normalize(PoseT<Scalar>& p) {
+  const Scalar n = std::sqrt(p.qw*p.qw + p.qx*p.qx + p.qy*p.qy + p.qz*p.qz);
+  if (n > Scalar(1e-12)) { p.qw /= n; p.qx /= n; p.qy /= n; p.qz /= n; }
+}
+
+// | |q| - 1 | — чтобы решить, пора ли нормировать
+template <class Scalar>
+inline Scalar normError(const PoseT<Scalar>& p) {
+  return std::fabs(std::sqrt(p.qw*p.qw + p.qx*p.qx + p.qy*p.qy + p.qz*p.qz) - Scalar(1));
+}
+
+inline PoseF toFloat(const Pose& p) {
+  return PoseF{ float(p.x), float(p.y), float(p.z), float(p.qw), float(p.qx), float(p.qy), float(p.qz) };
+}
+
+} // namespace PoseMath
@@ -1,9 +1,25 @@
 #pragma once
 #include "initaldate.h"
-#include <QStringList>  // нужно для QStringList в сигнатуре
+#include <string>
 
 namespace Presets {
 
+// Число звеньев базового робота из ТЗ
+inline constexpr size_t kTZ6Dof = 6;
+
+// База из ТЗ на 6 звеньев. В заголовке — чтобы её можно было отдать
+// в ConstChain<Presets::kTZ6> (fixed_chain.h) как константу компиляции.
+inline constexpr double kPi = 3.14159265358979323846;
+inline constexpr JointDH kTZ6[kTZ6Dof] = {
+  // theta_deg,   a_m,     d_m,     alpha_rad
+  {  15.0,        0.0,     0.213,   +kPi/2.0  }, // Joint 1
+  { -50.0,       -0.8,     0.193,    0.0      }, // Joint 2
+  { -60.0,      -0.590,   -0.160,    0.0      }, // Joint 3
+  {  95.0,        0.0,     0.250,   +kPi/2.0  }, // Joint 4
+  {  50.0,        0.0,     0.280,   -kPi/2.0  }, // Joint 5
+  {   0.0,        0.0,     0.250,    0.0      }, // Joint 6
+};
+
 // Вариант 1: дефолтная длина из пресета (внутренний kDof живёт в .cpp)
 Snapshot Default();
 
@@ -13,8 +29,9 @@ Snapshot Default(size_t dof);
 // Подписи колонок (с единицами) — фиксированные 4 шт.
 const char* const* ColumnHeaders();
 
-// Сгенерировать имена Joint 1..N для вертикальных заголовков.
-void MakeJointNames(size_t n, QStringList& out);
+// Имя сустава для вертикальных заголовков: "Joint 1".."Joint N" (index — с нуля).
+// Без Qt: ядро собирается отдельной библиотекой robotdh_core, список строк собирает Visual.
+std::string JointName(size_t index);
 
 } // namespace Presets
 
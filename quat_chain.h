@@ -0,0 +1,80 @@
+#pragma once
+#include "initaldate.h"
+#include "pose.h"
+#include <cmath>
+
+// Шаг DH на кватернионе + перенос (альтернатива аффинной 3x4 в FixedDH::step).
+// Поворот звена Rz(theta)*Rx(alpha) — произведение двух "осевых" кватернионов, поэтому
+// на звено уходит 8 умножений (4 при alpha = 0) вместо 12-18 на поворотную часть матрицы,
+// а накопленный поворот остаётся единичным кватернионом с дрейфом только по норме —
+// его снимает одно деление при выдаче кадра, без Грама-Шмидта по трём осям.
+// Используется CompiledChain::Backend::Quaternion (compiled_chain.h).
+namespace QuatDH {
+
+// Накопленная T0->i: поворот q (w, x, y, z) и позиция p
+struct Rigid {
+  double w, x, y, z;
+  double px, py, pz;
+};
+
+inline Rigid identity() { return Rigid{ 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 }; }
+
+// C = C * A(theta, a, d, alpha).
+// ch/sh — cos/sin(theta/2), cha/sha — cos/sin(alpha/2); alphaZero — пропустить Rx(alpha).
+inline void step(Rigid& C, double ch, double sh, double cha, double sha, bool alphaZero,
+                 double a, double d) {
+  // Перенос звена в СК предыдущего кадра: Rz(theta) * (a, 0, d)
+  const double ct = ch*ch - sh*sh, st = 2.0*sh*ch;
+  const double vx = a*ct, vy = a*st, vz = d;
+
+  // p += q v q*:  t = 2 (u x v),  v' = v + w t + u x t
+  const double tx = 2.0*(C.y*vz - C.z*vy);
+  const double ty = 2.0*(C.z*vx - C.x*vz);
+  const double tz = 2.0*(C.x*vy - C.y*vx);
+  C.px += vx + C.w*tx + (C.y*tz - C.z*ty);
+  C.py += vy + C.w*ty + (C.z*tx - C.x*tz);
+  C.pz += vz + C.w*tz + (C.x*ty - C.y*tx);
+
+  // q = q * (ch, 0, 0, sh)
+  double w = C.w*ch - C.z*sh;
+  double x = C.x*ch + C.y*sh;
+  double y = C.y*ch - C.x*sh;
+  double z = C.z*ch + C.w*sh;
+
+  // q = q * (cha, sha, 0, 0)
+  if (!alphaZero) {
+    const double w2 = w*cha - x*sha;
+    const double x2 = x*cha + w*sha;
+    const double y2 = y*cha + z*sha;
+    const double z2 = z*cha - y*sha;
+    w = w2; x = x2; y = y2; z = z2;
+  }
+  C.w = w; C.x = x; C.y = y; C.z = z;
+}
+
+// Кадр в Interp. Множитель 2/|q|^2 вместо 2 даёт ортонормированную матрицу при любой
+// норме q, поэтому дрейф нормы на оси не переходит и sqrt не нужен.
+inline Interp interpret(const Rigid& C) {
+  const double w = C.w, x = C.x, y = C.y, z = C.z;
+  const double s = 2.0 / (w*w + x*x + y*y + z*z);
+  Interp f{};
+  f.x = C.px; f.y = C.py; f.z = C.pz;
+  f.xx = 1.0 - s*(y*y + z*z); f.xy = s*(x*y + z*w);       f.xz = s*(x*z - y*w);
+  f.yx = s*(x*y - z*w);       f.yy = 1.0 - s*(x*x + z*z); f.yz = s*(y*z + x*w);
+  f.zx = s*(x*z + y*w);       f.zy = s*(y*z - x*w);       f.zz = 1.0 - s*(x*x + y*y);
+  return f;
+}
+
+// Кадр в Pose: кватернион как есть (знак — qw >= 0, как у PoseMath::fromAffine)
+inline Pose toPose(const Rigid& C) {
+  const double sgn = (C.w < 0.0) ? -1.0 : 1.0;
+  return Pose{ C.px, C.py, C.pz, sgn*C.w, sgn*C.x, sgn*C.y, sgn*C.z };
+}
+
+// Нормировать накопленный кватернион (периодически на длинных цепях)
+inline void renormalize(Rigid& C) {
+  const double n = std::sqrt(C.w*C.w + C.x*C.x + C.y*C.y + C.z*C.z);
+  if (n > 1e-12) { C.w /= n; C.x /= n; C.y /= n; C.z /= n; }
+}
+
+} // namespace QuatDH
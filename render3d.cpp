@@ -1,8 +1,10 @@
 #include "render3d.h"
+#include "collision.h"
 
 #include <Qt3DCore/QComponent>
 #include <Qt3DExtras/QPhongAlphaMaterial>
 #include <Qt3DRender/QPointLight>
+#include <Qt3DRender/QRenderSettings>
 #include <Qt3DExtras/QForwardRenderer>
 #include <Qt3DRender/QMaterial>
 #include <Qt3DExtras/QExtrudedTextMesh>
@@ -11,6 +13,7 @@
 #include <QMouseEvent>
 #include <QFont>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 
 Render3D::Render3D(QObject* parent) : QObject(parent) {}
@@ -18,9 +21,19 @@ Render3D::Render3D(QObject* parent) : QObject(parent) {}
 void Render3D::initInto(QFrame* container) {
   if (!container) return;
 
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+  // Шейдеры InstancedCylinders — только GLSL 150 под OpenGL-рендерер Qt3D. Не заданный
+  // рендерер (в Qt 6 по умолчанию RHI) просим OpenGL — переменная читается при создании окна;
+  // выбор пользователя не трогаем, под RHI цилиндры рисуются отдельными сущностями
+  if (!qEnvironmentVariableIsSet("QT3D_RENDERER")) qputenv("QT3D_RENDERER", "opengl");
+  instanced_ = qgetenv("QT3D_RENDERER") == "opengl";
+#endif
+
   // Qt3D окно
   view_ = new Qt3DExtras::Qt3DWindow();
   view_->defaultFrameGraph()->setClearColor(QColor(240,240,240)); // light gray
+  // Кадр рисуется только при изменениях сцены/камеры: в простое окно не грузит CPU и GPU
+  view_->renderSettings()->setRenderPolicy(Qt3DRender::QRenderSettings::OnDemand);
 
   // Контейнер для встраивания в обычный виджет
   viewContainer_ = QWidget::createWindowContainer(view_, container);
@@ -72,41 +85,91 @@ void Render3D::initInto(QFrame* container) {
 }
 
 void Render3D::setData(const Results& results) {
+  prev_.swap(results_);
   results_ = results;
+  if (!root_) return;
+  ensureScene();
+
+  // Смена DOF или масштаба — переставить всё; иначе только звенья с изменившимися кадрами
+  const size_t n = results_.size();
+  const bool styleChanged = updateStyle();
+  const bool all = styleChanged || prev_.size() != n;
+  resizeJointPool(n);
+
+  std::vector<char> changed(n, 1);
+  if (!all) {
+    for (size_t i = 0; i < n; ++i)
+      changed[i] = std::memcmp(&prev_[i], &results_[i], sizeof(Interp)) != 0;
+  }
+
+  if (all || (n > 0 && changed[0])) buildBaseAxes();
+  for (size_t i = 0; i < n; ++i) {
+    // Сегменты звена i зависят от кадров i-1 (X_i), i и i+1 (Z_i и длины осей)
+    const bool dirty = all || changed[i] || (i > 0 && changed[i - 1]) || (i + 1 < n && changed[i + 1]);
+    if (dirty) buildJointAxes(i);
+  }
+  if (all || (n > 0 && changed[n - 1])) buildTCP();
+  uploadCylinders();
+}
 
+bool Render3D::updateStyle() {
   // Авто-масштаб по данным, чтобы оси/трубки были адекватной толщины
   float maxR = 1.0f;
   for (const auto& r : results_) {
     maxR = std::max(maxR, float(std::sqrt(r.x*r.x + r.y*r.y + r.z*r.z)));
   }
-  baseAxesLen_ = std::max(0.3f, maxR * 0.3f);
-  axisRadius_  = std::max(0.006f, maxR * 0.01f);
-  tubeRadius_  = std::max(0.009f, maxR * 0.018f)* 2.0f;
-
-  clearScene();
-  buildBaseAxes();
-  buildJointAxes();
-  buildTCP();
+  const float len  = std::max(0.3f, maxR * 0.3f);
+  const float axis = std::max(0.006f, maxR * 0.01f);
+  // Радиус трубок — тот же, что у капсул Collision (одна формула на оба модуля)
+  const float tube = float(Collision::tubeRadius(results_.data(), results_.size()));
+
+  const bool changed = len != baseAxesLen_ || axis != axisRadius_ || tube != tubeRadius_;
+  baseAxesLen_ = len;
+  axisRadius_  = axis;
+  tubeRadius_  = tube;
+  return changed;
 }
 
-void Render3D::clearScene() {
-  if (!root_) return;
-
-  labels_.clear();
+/*===========================  ПУЛ СЦЕНЫ  ===========================*/
+
+void Render3D::ensureScene() {
+  if (sceneReady_ || !root_) return;
+  sceneReady_ = true;
+
+  if (instanced_) {
+    cylinders_ = new InstancedCylinders(root_);
+    cylinders_->setLight(QVector3D(10.f, 12.f, 10.f), 1.5f);   // как keep_light в initInto
+    cylinders_->resize(kBaseSlots);
+  } else {
+    unitCylinder_ = new Qt3DExtras::QCylinderMesh(root_);
+    unitCylinder_->setRadius(1.0f);
+    unitCylinder_->setLength(1.0f);
+    unitCylinder_->setRings(16);
+    unitCylinder_->setSlices(24);
+    cylinderParts_.resize(kBaseSlots);
+  }
 
-  const auto ents = root_->findChildren<Qt3DCore::QEntity*>(
-      QString(), Qt::FindDirectChildrenOnly);
+  unitSphere_ = new Qt3DExtras::QSphereMesh(root_);
+  unitSphere_->setRadius(1.0f);
+  unitSphere_->setRings(24);
+  unitSphere_->setSlices(24);
 
-  for (Qt3DCore::QEntity* e : ents) {
-    if (!e) continue;
+  tcpSphere_   = makeSpherePart(tcpColor_, 1.0f);
 
-    // НЕ удаляем свет, контроллер и (на всякий) камеру
-    if (e->objectName() == QStringLiteral("keep_light")) continue;
-    if (e == camera_) continue;
-    if (qobject_cast<Qt3DExtras::QOrbitCameraController*>(e)) continue;
+  baseLabels_[0] = makeTextLabel("X", axisXColor_);
+  baseLabels_[1] = makeTextLabel("Y", axisYColor_);
+  baseLabels_[2] = makeTextLabel("Z", axisZColor_);
+  tcpLabel_      = makeTextLabel("TCP", tcpColor_);
+}
 
-    e->deleteLater();
-  }
+void Render3D::resizeJointPool(size_t dof) {
+  // Новые слоты скрыты, лишние просто отбрасываются — сущности не создаются и не удаляются
+  const size_t slots = kBaseSlots + dof * kJointSlots;
+  if (cylinders_) { cylinders_->resize(slots); return; }
+  // Без инстансинга лишние сущности удаляем, новые создаст placeCylinder
+  for (size_t k = slots; k < cylinderParts_.size(); ++k)
+    if (cylinderParts_[k].part.entity) cylinderParts_[k].part.entity->deleteLater();
+  cylinderParts_.resize(slots);
 }
 
 /*===========================  ПОСТРОЕНИЕ БАЗЫ  ===========================*/
@@ -114,16 +177,17 @@ void Render3D::clearScene() {
 void Render3D::buildBaseAxes() {
     // Базовые оси (XYZ) вокруг (0,0,0). Подписи — ТОЛЬКО здесь.
     const float L = baseAxesLen_;
-    makeAxisEntity({0,0,0}, {1,0,0}, L, axisXColor_, axisRadius_);
-    makeAxisEntity({0,0,0}, {0,1,0}, L, axisYColor_, axisRadius_);
-    makeAxisEntity({0,0,0}, {0,0,1}, L, axisZColor_, axisRadius_);
+    placeCylinder(kBaseAxisX, {0,0,0}, {1,0,0}, L, axisRadius_, axisXColor_);
+    placeCylinder(kBaseAxisY, {0,0,0}, {0,1,0}, L, axisRadius_, axisYColor_);
+    placeCylinder(kBaseAxisZ, {0,0,0}, {0,0,1}, L, axisRadius_, axisZColor_);
 
     const float txt = std::max(0.045f, L*0.12f);
-    makeTextLabel({ L,0,0 },  "X", txt, axisXColor_);
-    makeTextLabel({ 0, L,0 }, "Y", txt, axisYColor_);
-    makeTextLabel({ 0,0, L }, "Z", txt, axisZColor_);
+    placeLabel(baseLabels_[0], { L,0,0 },  txt);
+    placeLabel(baseLabels_[1], { 0, L,0 }, txt);
+    placeLabel(baseLabels_[2], { 0,0, L }, txt);
 
     // Цилиндр базы ТОЛЬКО по Z: от (0,0,0) до p0, с УЧЁТОМ знака проекции
+    hideCylinder(kBaseTube);
     if (!results_.empty()) {
       const QVector3D p0 = toVec3(results_.front().x, results_.front().y, results_.front().z);
       const QVector3D zBase(0,0,1);
@@ -131,238 +195,218 @@ void Render3D::buildBaseAxes() {
       const float Lz   = std::fabs(proj);
       const QVector3D dirZ = (proj >= 0.f) ? zBase : -zBase;
       if (Lz > 1e-6f) {
-        makeCylinder({0,0,0}, dirZ, Lz, tubeRadius_, axisZColor_);
+        placeCylinder(kBaseTube, {0,0,0}, dirZ, Lz, tubeRadius_, axisZColor_);
       }
     }
 }
 
 /*===========================  ПОСТРОЕНИЕ ЗВЕНЬЕВ  ===========================*/
 
-void Render3D::buildJointAxes() {
-  if (results_.empty()) return;
+void Render3D::buildJointAxes(size_t index) {
+  if (index >= results_.size() || jointSlot(index, kJointSlots) > cylinderSlots()) return;
 
   const int last = int(results_.size()) - 1; // TCP = last, для него цилиндры не строим
+  const int i = int(index);
+  auto slot = [&](size_t k){ return jointSlot(index, k); };
 
-  auto ex_i = [&](int i){ const auto& r = results_[size_t(i)];
+  auto ex_i = [&](int k){ const auto& r = results_[size_t(k)];
                           return toVec3(r.xx, r.xy, r.xz).normalized(); };
-  auto ey_i = [&](int i){ const auto& r = results_[size_t(i)];
+  auto ey_i = [&](int k){ const auto& r = results_[size_t(k)];
                           return toVec3(r.yx, r.yy, r.yz).normalized(); };
-  auto ez_i = [&](int i){ const auto& r = results_[size_t(i)];
+  auto ez_i = [&](int k){ const auto& r = results_[size_t(k)];
                           return toVec3(r.zx, r.zy, r.zz).normalized(); };
-  auto p_i  = [&](int i){ const auto& r = results_[size_t(i)];
+  auto p_i  = [&](int k){ const auto& r = results_[size_t(k)];
                           return toVec3(r.x, r.y, r.z); };
 
-  for (int i = 0; i <= last; ++i) {
-    const QVector3D p   = p_i(i);
-    const QVector3D ex  = ex_i(i);
-    const QVector3D ey  = ey_i(i);
-    const QVector3D ez  = ez_i(i);
-
-    /* ---------- Z_i: цилиндр от p_i до p_{i+1} в проекции на z_i ---------- */
-    float Lz_len = 0.0f;          // модуль длины цилиндра
-    QVector3D dirZ = ez;          // реальное направление цилиндра (с учётом знака)
-    if (i < last) {
-      const QVector3D dp = p_i(i+1) - p;          // вектор до следующего начала СК
-      const float proj = signedProjLen(dp, ez);   // может быть < 0
-      Lz_len = std::fabs(proj);
-      dirZ   = (proj >= 0.f) ? ez : -ez;
-    }
-    // длины осей (оси — всегда вдоль +ex/+ey/+ez, длина по модулю сегмента Z)
-    const float Lz_axis = (Lz_len > 0.f) ? (Lz_len * 1.5f) : (baseAxesLen_ * 0.6f);
-    const float Ly_axis = Lz_axis;
-
-    /* ---------- X_i: цилиндр от проекции p_i на Z_{i-1} до p_i ---------- */
-    float Lx_len = 0.0f;         // модуль длины цилиндра
-    QVector3D X_start = p;       // заменится вычислением
-    QVector3D dirX = ex;         // реальное направление цилиндра (с учётом знака)
-
-    if (i == 0) {
-      // Z_{-1} := z_base через (0,0,0)
-      const QVector3D zBase(0,0,1);
-      const float t = QVector3D::dotProduct(p - QVector3D(0,0,0), zBase);
-      const QVector3D s = QVector3D(0,0,0) + zBase * t; // точка на Z_base
-      X_start = s;
-      const float proj = signedProjLen(p - s, ex);
-      Lx_len = std::fabs(proj);
-      dirX   = (proj >= 0.f) ? ex : -ex;
-    } else {
-      // проекция p_i на линию Z_{i-1} : s = p_{i-1} + ez_{i-1} * t
-      const QVector3D pPrev = p_i(i-1);
-      const QVector3D zPrev = ez_i(i-1);
-      const float t = QVector3D::dotProduct(p - pPrev, zPrev);
-      const QVector3D s = pPrev + zPrev * t;
-      X_start = s;
-      const float proj = signedProjLen(p - s, ex);
-      Lx_len = std::fabs(proj);
-      dirX   = (proj >= 0.f) ? ex : -ex;
-    }
-    const bool buildX = (Lx_len > 1e-5f);               // если почти ноль — X не строим
-    const float Lx_axis = buildX ? (Lx_len * 1.5f) : 0;  // ось — вперёд по +X (показываем базис)
-
-    /* ---------- Оси (тонкие) всегда из p_i ---------- */
-    if (buildX) makeAxisEntity(p, ex, Lx_axis, axisXColor_, axisRadius_);
-    makeAxisEntity(p, ey, Ly_axis, axisYColor_, axisRadius_);
-    makeAxisEntity(p, ez, Lz_axis, axisZColor_, axisRadius_);
-
-    /* ---------- Цилиндры (толстые) ---------- */
-    if (buildX) {
-      makeCylinder(X_start, dirX, Lx_len, tubeRadius_, axisXColor_);
-    }
-    if (Lz_len > 1e-6f && i < last) {
-      makeCylinder(p, dirZ, Lz_len, tubeRadius_, axisZColor_);
-    }
+  const QVector3D p   = p_i(i);
+  const QVector3D ex  = ex_i(i);
+  const QVector3D ey  = ey_i(i);
+  const QVector3D ez  = ez_i(i);
+
+  /* ---------- Z_i: цилиндр от p_i до p_{i+1} в проекции на z_i ---------- */
+  float Lz_len = 0.0f;          // модуль длины цилиндра
+  QVector3D dirZ = ez;          // реальное направление цилиндра (с учётом знака)
+  if (i < last) {
+    const QVector3D dp = p_i(i+1) - p;          // вектор до следующего начала СК
+    const float proj = signedProjLen(dp, ez);   // может быть < 0
+    Lz_len = std::fabs(proj);
+    dirZ   = (proj >= 0.f) ? ez : -ez;
+  }
+  // длины осей (оси — всегда вдоль +ex/+ey/+ez, длина по модулю сегмента Z)
+  const float Lz_axis = (Lz_len > 0.f) ? (Lz_len * 1.5f) : (baseAxesLen_ * 0.6f);
+  const float Ly_axis = Lz_axis;
+
+  /* ---------- X_i: цилиндр от проекции p_i на Z_{i-1} до p_i ---------- */
+  float Lx_len = 0.0f;         // модуль длины цилиндра
+  QVector3D X_start = p;       // заменится вычислением
+  QVector3D dirX = ex;         // реальное направление цилиндра (с учётом знака)
+
+  if (i == 0) {
+    // Z_{-1} := z_base через (0,0,0)
+    const QVector3D zBase(0,0,1);
+    const float t = QVector3D::dotProduct(p - QVector3D(0,0,0), zBase);
+    const QVector3D s = QVector3D(0,0,0) + zBase * t; // точка на Z_base
+    X_start = s;
+    const float proj = signedProjLen(p - s, ex);
+    Lx_len = std::fabs(proj);
+    dirX   = (proj >= 0.f) ? ex : -ex;
+  } else {
+    // проекция p_i на линию Z_{i-1} : s = p_{i-1} + ez_{i-1} * t
+    const QVector3D pPrev = p_i(i-1);
+    const QVector3D zPrev = ez_i(i-1);
+    const float t = QVector3D::dotProduct(p - pPrev, zPrev);
+    const QVector3D s = pPrev + zPrev * t;
+    X_start = s;
+    const float proj = signedProjLen(p - s, ex);
+    Lx_len = std::fabs(proj);
+    dirX   = (proj >= 0.f) ? ex : -ex;
   }
+  const bool buildX = (Lx_len > 1e-5f);               // если почти ноль — X не строим
+  const float Lx_axis = buildX ? (Lx_len * 1.5f) : 0;  // ось — вперёд по +X (показываем базис)
+
+  /* ---------- Оси (тонкие) всегда из p_i ---------- */
+  if (buildX) placeCylinder(slot(kAxisX), p, ex, Lx_axis, axisRadius_, axisXColor_);
+  else        hideCylinder(slot(kAxisX));
+  placeCylinder(slot(kAxisY), p, ey, Ly_axis, axisRadius_, axisYColor_);
+  placeCylinder(slot(kAxisZ), p, ez, Lz_axis, axisRadius_, axisZColor_);
+
+  /* ---------- Цилиндры (толстые) ---------- */
+  if (buildX) placeCylinder(slot(kTubeX), X_start, dirX, Lx_len, tubeRadius_, axisXColor_);
+  else        hideCylinder(slot(kTubeX));
+  if (Lz_len > 1e-6f && i < last) placeCylinder(slot(kTubeZ), p, dirZ, Lz_len, tubeRadius_, axisZColor_);
+  else                            hideCylinder(slot(kTubeZ));
 }
 
 
 /*===========================  TCP  ===========================*/
 
 void Render3D::buildTCP() {
-  if (results_.empty()) return;
+  if (results_.empty()) {
+    hide(tcpSphere_);
+    if (tcpLabel_ < labels_.size()) labels_[tcpLabel_].entity->setEnabled(false);
+    return;
+  }
   const auto& e = results_.back();
   const QVector3D p = toVec3(e.x, e.y, e.z);
 
   // Синяя сфера TCP
   const float r = std::max(axisRadius_*1.2f, 0.015f) * 4.0f;
-  makeSphere(p, r, tcpColor_, 1.0f);
+  placeSphere(tcpSphere_, p, r);
 
   // Подпись TCP (синяя), чуть сместим к камере и вверх
   const float s = std::max(0.045f, baseAxesLen_*0.12f);
-  makeTextLabel(p + QVector3D(0, s, 0), "TCP", s, tcpColor_);
+  placeLabel(tcpLabel_, p + QVector3D(0, s, 0), s);
 }
 
 /*===========================  БИЛДЕРЫ ПРИМИТИВОВ  ===========================*/
 
-Qt3DCore::QEntity* Render3D::makeAxisEntity(const QVector3D& origin,
-                                            const QVector3D& dir,
-                                            float length,
-                                            const QColor& color,
-                                            float radius) {
-  QVector3D d = dir;
-  if (d.lengthSquared() < 1e-12f) return nullptr;
-  d.normalize();
-
-  auto* entity = new Qt3DCore::QEntity(root_);
-
-  auto* mesh = new Qt3DExtras::QCylinderMesh();
-  mesh->setLength(length);
-  mesh->setRadius(radius);
-  mesh->setRings(16);
-  mesh->setSlices(24);
-
-  auto* mat = new Qt3DExtras::QPhongMaterial();
-  mat->setDiffuse(color);
-
-  auto* tr = new Qt3DCore::QTransform();
-  tr->setRotation(rotationFromYTo(d));
-  tr->setTranslation(origin + d * (length * 0.5f));
-
-  entity->addComponent(mesh);
-  entity->addComponent(mat);
-  entity->addComponent(tr);
-  return entity;
-}
+Qt3DRender::QMaterial* Render3D::material(const QColor& color, float alpha, bool alphaBlend) {
+  const QRgb rgb = color.rgba();
+  for (const auto& m : materials_) {
+    if (m.rgb == rgb && m.alpha == alpha && m.alphaBlend == alphaBlend) return m.material;
+  }
 
-Qt3DCore::QEntity* Render3D::makeCylinder(const QVector3D& origin,
-                                          const QVector3D& dir,
-                                          float length,
-                                          float radius,
-                                          const QColor& color) {
-  QVector3D d = dir;
-  if (d.lengthSquared() < 1e-12f || length <= 0.f) return nullptr;
-  d.normalize();
-
-  auto* e = new Qt3DCore::QEntity(root_);
-  auto* mesh = new Qt3DExtras::QCylinderMesh();
-  mesh->setLength(length);
-  mesh->setRadius(radius);
-  mesh->setRings(16);
-  mesh->setSlices(24);
-
-  auto* mat = new Qt3DExtras::QPhongMaterial();
-  mat->setDiffuse(color);
-
-  auto* tr = new Qt3DCore::QTransform();
-  tr->setRotation(rotationFromYTo(d));
-  tr->setTranslation(origin + d * (length * 0.5f));
-
-  e->addComponent(mesh);
-  e->addComponent(mat);
-  e->addComponent(tr);
-  return e;
+  Qt3DRender::QMaterial* mat = nullptr;
+  if (alphaBlend) {
+    auto* phong = new Qt3DExtras::QPhongAlphaMaterial(root_);
+    phong->setDiffuse(color);
+    phong->setAlpha(alpha);
+    mat = phong;
+  } else {
+    auto* phong = new Qt3DExtras::QPhongMaterial(root_);
+    phong->setDiffuse(color);
+    mat = phong;
+  }
+  materials_.push_back({rgb, alpha, alphaBlend, mat});
+  return mat;
 }
 
-Qt3DCore::QEntity* Render3D::makeSphere(const QVector3D& center,
-                                        float radius,
-                                        const QColor& color,
-                                        float alpha) {
-  auto* e = new Qt3DCore::QEntity(root_);
-  auto* mesh = new Qt3DExtras::QSphereMesh();
-  mesh->setRadius(radius);
-  mesh->setRings(24);
-  mesh->setSlices(24);
-
-  Qt3DExtras::QPhongAlphaMaterial* mat = new Qt3DExtras::QPhongAlphaMaterial();
-  mat->setDiffuse(color);
-  mat->setAlpha(alpha);
-
-  auto* tr = new Qt3DCore::QTransform();
-  tr->setTranslation(center);
-
-  e->addComponent(mesh);
-  e->addComponent(mat);
-  e->addComponent(tr);
-  return e;
+Render3D::Part Render3D::makeSpherePart(const QColor& color, float alpha) {
+  Part p;
+  p.entity = new Qt3DCore::QEntity(root_);
+  p.xform = new Qt3DCore::QTransform(p.entity);
+
+  p.entity->addComponent(unitSphere_);
+  p.entity->addComponent(material(color, alpha, true));
+  p.entity->addComponent(p.xform);
+  p.entity->setEnabled(false);
+  return p;
 }
 
-Qt3DCore::QEntity* Render3D::makeTextLabel(const QVector3D& pos,
-                                           const QString& text,
-                                           float scale,
-                                           const QColor& color)
+size_t Render3D::makeTextLabel(const QString& text, const QColor& color)
 {
-    auto* e   = new Qt3DCore::QEntity(root_);
-    auto* m   = new Qt3DExtras::QExtrudedTextMesh();
-    m->setText(text);
-    m->setDepth(std::max(0.003f, scale * 0.15f));
-    m->setFont(QFont("DejaVu Sans", 96, QFont::DemiBold));
-
-    auto* mat = new Qt3DExtras::QPhongMaterial();
-    mat->setDiffuse(color);
+    TextBillboard L;
+    L.entity = new Qt3DCore::QEntity(root_);
+    L.mesh   = new Qt3DExtras::QExtrudedTextMesh(L.entity);
+    L.mesh->setText(text);
+    L.mesh->setFont(QFont("DejaVu Sans", 96, QFont::DemiBold));
 
     // Трансформ: базовая позиция (смещение и поворот к камере обновляем в onFrameUpdate)
-    auto* tr = new Qt3DCore::QTransform();
-    tr->setScale(scale);
-    tr->setTranslation(pos);
+    L.xform = new Qt3DCore::QTransform(L.entity);
 
-    e->addComponent(m);
-    e->addComponent(mat);
-    e->addComponent(tr);
+    L.entity->addComponent(L.mesh);
+    L.entity->addComponent(material(color));   // меш у каждой подписи свой, материал общий
+    L.entity->addComponent(L.xform);
+    L.entity->setEnabled(false);
 
     // Запомним для динамического смещения/поворота к камере
-    labels_.push_back({ pos, scale, tr });
-    return e;
+    labels_.push_back(L);
+    return labels_.size() - 1;
 }
 
+void Render3D::placeCylinder(size_t slot, const QVector3D& origin, const QVector3D& dir,
+                             float length, float radius, const QColor& color) {
+  // Масштаб (r, L, r), поворот +Y -> dir и центр в середине отрезка — в матрице экземпляра
+  if (cylinders_) { cylinders_->set(slot, origin, dir, length, radius, color); return; }
+
+  if (slot >= cylinderParts_.size()) return;
+  CylinderPart& c = cylinderParts_[slot];
+  QMatrix4x4 m;
+  if (!InstancedCylinders::modelMatrix(origin, dir, length, radius, m)) { hide(c.part); return; }
+  if (!c.part.entity) {
+    c.part.entity = new Qt3DCore::QEntity(root_);
+    c.part.xform  = new Qt3DCore::QTransform(c.part.entity);
+    c.part.entity->addComponent(unitCylinder_);
+    c.part.entity->addComponent(c.part.xform);
+  }
+  Qt3DRender::QMaterial* mat = material(color);
+  if (mat != c.material) {
+    if (c.material) c.part.entity->removeComponent(c.material);
+    c.part.entity->addComponent(mat);
+    c.material = mat;
+  }
+  c.part.xform->setMatrix(m);
+  c.part.entity->setEnabled(true);
+}
 
+void Render3D::hideCylinder(size_t slot) {
+  if (cylinders_) cylinders_->hide(slot);
+  else if (slot < cylinderParts_.size()) hide(cylinderParts_[slot].part);
+}
 
-/*===========================  МАТЕМАТИКА  ===========================*/
-
-QQuaternion Render3D::rotationFromYTo(const QVector3D& dir) {
-  // Базовый цилиндр ориентирован вдоль +Y (0,1,0)
-  static const QVector3D up(0.f, 1.f, 0.f);
-  QVector3D d = dir.normalized();
+void Render3D::placeSphere(Part& p, const QVector3D& center, float radius) {
+  if (!p.entity) return;
+  p.xform->setScale(radius);
+  p.xform->setTranslation(center);
+  p.entity->setEnabled(true);
+}
 
-  const float dot = QVector3D::dotProduct(up, d);
-  if (dot > 0.9999f) return QQuaternion();
-  if (dot < -0.9999f) {
-    // Противоположные направления: поворот на 180° вокруг любой оси, ортогональной up
-    return QQuaternion::fromAxisAndAngle(QVector3D(1,0,0), 180.0f);
-  }
-  const QVector3D axis = QVector3D::crossProduct(up, d).normalized();
-  const float angleDeg = std::acos(std::clamp(dot, -1.0f, 1.0f)) * 180.0f / float(M_PI);
-  return QQuaternion::fromAxisAndAngle(axis, angleDeg);
+void Render3D::placeLabel(size_t label, const QVector3D& pos, float scale) {
+  if (label >= labels_.size()) return;
+  TextBillboard& L = labels_[label];
+  L.basePos = pos;
+  L.scale   = scale;
+  L.mesh->setDepth(std::max(0.003f, scale * 0.15f));   // сеттер не трогает меш, если глубина та же
+  L.xform->setScale(scale);
+  L.xform->setTranslation(pos);
+  L.entity->setEnabled(true);
+  labelsDirty_ = true;   // отступ и поворот к камере — в ближайшем onFrameUpdate
 }
 
+
+
+/*===========================  МАТЕМАТИКА  ===========================*/
+
 bool Render3D::closestPointsOnLines(const QVector3D& p1, const QVector3D& u,
                                     const QVector3D& p2, const QVector3D& v,
                                     QVector3D& q1, QVector3D& q2) {
@@ -397,31 +441,45 @@ bool Render3D::closestPointsOnLines(const QVector3D& p1, const QVector3D& u,
 void Render3D::showIdleScene() {
   // просто базовые оси одинаковой длины + подписи + цилиндр Z = 50% длины оси
   results_.clear();
-  clearScene();
+  prev_.clear();
+  if (!root_) return;
+  ensureScene();
+  resizeJointPool(0);
+  buildTCP();   // пустые результаты — TCP скрыт
 
   const float L = 0.6f; // произвольная "красивая" длина на старте
-  makeAxisEntity({0,0,0}, {1,0,0}, L, axisXColor_, axisRadius_);
-  makeAxisEntity({0,0,0}, {0,1,0}, L, axisYColor_, axisRadius_);
-  makeAxisEntity({0,0,0}, {0,0,1}, L, axisZColor_, axisRadius_);
+  placeCylinder(kBaseAxisX, {0,0,0}, {1,0,0}, L, axisRadius_, axisXColor_);
+  placeCylinder(kBaseAxisY, {0,0,0}, {0,1,0}, L, axisRadius_, axisYColor_);
+  placeCylinder(kBaseAxisZ, {0,0,0}, {0,0,1}, L, axisRadius_, axisZColor_);
 
   const float txt = std::max(0.045f, L*0.12f);
-  makeTextLabel({ L,0,0 },  "X", txt, axisXColor_);
-  makeTextLabel({ 0, L,0 }, "Y", txt, axisYColor_);
-  makeTextLabel({ 0,0, L }, "Z", txt, axisZColor_);
+  placeLabel(baseLabels_[0], { L,0,0 },  txt);
+  placeLabel(baseLabels_[1], { 0, L,0 }, txt);
+  placeLabel(baseLabels_[2], { 0,0, L }, txt);
 
   // цилиндр только по Z, короче на 50%
-  makeCylinder({0,0,0}, {0,0,1}, L * 0.5f, tubeRadius_ * 2.0f, axisZColor_);
+  placeCylinder(kBaseTube, {0,0,0}, {0,0,1}, L * 0.5f, tubeRadius_ * 2.0f, axisZColor_);
+  uploadCylinders();
 }
 
 void Render3D::onFrameUpdate(float /*dt*/)
 {
     if (!camera_) return;
 
+    // Поворот к камере зависит только от её положения и up-вектора и от базовых позиций
+    // подписей (placeLabel): пока ничего из этого не менялось, кадр ничего не стоит
+    const QVector3D camPos = camera_->position();
+    const QVector3D camUp  = camera_->upVector();
+    if (!labelsDirty_ && camPos == labelCamPos_ && camUp == labelCamUp_) return;
+    labelsDirty_ = false;
+    labelCamPos_ = camPos;
+    labelCamUp_  = camUp;
+
     for (auto& L : labels_)
     {
-        if (!L.xform) continue;
+        if (!L.xform || !L.entity->isEnabled()) continue;
 
-        QVector3D toCam = (camera_->position() - L.basePos);
+        QVector3D toCam = (camPos - L.basePos);
         const float len2 = toCam.lengthSquared();
         if (len2 < 1e-9f) {
             toCam = QVector3D(0,0,1);
@@ -434,7 +492,7 @@ void Render3D::onFrameUpdate(float /*dt*/)
         L.xform->setTranslation(L.basePos + toCam * nudge);
 
         // развернуть текст
-        L.xform->setRotation(billboardUpright(toCam, camera_->upVector()));
+        L.xform->setRotation(billboardUpright(toCam, camUp));
 
     }
 }
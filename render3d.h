@@ -3,6 +3,7 @@
 #include <QWidget>
 #include <QFrame>
 #include <QVector3D>
+#include <QColor>
 #include <vector>
 
 // Qt3D
@@ -17,12 +18,17 @@
 #include <Qt3DLogic/QFrameAction>
 
 #include "initaldate.h" // Results
+#include "instanced_cylinders.h"
+
+namespace Qt3DExtras { class QExtrudedTextMesh; }
 
 struct TextBillboard
 {
-    QVector3D             basePos;
-    float                 scale = 1.0f;
-    Qt3DCore::QTransform* xform = nullptr;
+    QVector3D                      basePos;
+    float                          scale = 1.0f;
+    Qt3DCore::QTransform*          xform = nullptr;
+    Qt3DCore::QEntity*             entity = nullptr;
+    Qt3DExtras::QExtrudedTextMesh* mesh = nullptr;
 };
 
 // Рендерер 3D-сцены по результатам вычислений.
@@ -37,6 +43,16 @@ struct TextBillboard
 // - База: рисуем оси + подписи; цилиндр базы только по Z_base до пересечения с X0;
 //   по X_base цилиндр НЕ строим.
 // - TCP: красная сфера + подпись "TCP".
+//
+// Все цилиндры (оси и трубки базы и звеньев) — экземпляры одного InstancedCylinders:
+// один вызов отрисовки на всю цепь. Слоты: kBaseSlots базовых, затем kJointSlots на кадр.
+// Под RHI-рендерером Qt 6 (шейдеры InstancedCylinders только GL) слот — отдельная сущность
+// с единичным QCylinderMesh и той же матрицей.
+// Число слотов меняется лишь при смене DOF; на новые Results переставляются цилиндры тех
+// звеньев, чьи кадры (или соседние — от них зависят длины сегментов) изменились, и буфер
+// экземпляров уходит на GPU одной записью в конце setData.
+// Сфера TCP и подписи — отдельные сущности из пула, с общими мешем и материалами по
+// цвету/прозрачности, размер и положение — в QTransform.
 
 class Render3D : public QObject {
   Q_OBJECT
@@ -63,34 +79,44 @@ public:
   void showIdleScene();
 
 private:
-  // --- построение сцены ---
-  void clearScene();
-  void buildBaseAxes();   // базовые оси + подписи + цилиндр по Z_base
-  void buildJointAxes();  // оси+цилиндры для звеньев (по Results)
-  void buildTCP();        // сфера и подпись TCP
-
-  // --- билдеры примитивов ---
-  Qt3DCore::QEntity* makeAxisEntity(const QVector3D& origin,
-                                    const QVector3D& dir,
-                                    float length,
-                                    const QColor& color,
-                                    float radius = 0.01f);
-  Qt3DCore::QEntity* makeCylinder(const QVector3D& origin,
-                                  const QVector3D& dir,
-                                  float length,
-                                  float radius,
-                                  const QColor& color);
-  Qt3DCore::QEntity* makeSphere(const QVector3D& center,
-                                float radius,
-                                const QColor& color,
-                                float alpha = 1.0f);
-  Qt3DCore::QEntity* makeTextLabel(const QVector3D& pos,
-                                   const QString& text,
-                                   float scale,
-                                   const QColor& color);
+  // Примитив из пула: сущность + её трансформ (меш и материал не меняются)
+  struct Part {
+    Qt3DCore::QEntity*    entity = nullptr;
+    Qt3DCore::QTransform* xform  = nullptr;
+  };
+  // Слоты цилиндров: база, затем на кадр i (buildJointAxes) оси из p_i и сегменты X_i / Z_i
+  enum BaseSlot : size_t { kBaseAxisX, kBaseAxisY, kBaseAxisZ, kBaseTube, kBaseSlots };
+  enum JointSlot : size_t { kAxisX, kAxisY, kAxisZ, kTubeX, kTubeZ, kJointSlots };
+  static size_t jointSlot(size_t i, size_t k) { return kBaseSlots + i * kJointSlots + k; }
+
+  // --- пул сцены ---
+  void ensureScene();                 // цилиндры, TCP, подписи — один раз после initInto
+  void resizeJointPool(size_t dof);   // число слотов цилиндров (только при смене DOF)
+  bool updateStyle();                 // масштаб осей/трубок по results_; true — изменился
+
+  // --- обновление сцены ---
+  void buildBaseAxes();           // базовые оси + подписи + цилиндр по Z_base
+  void buildJointAxes(size_t i);  // оси+цилиндры звена i (по Results)
+  void buildTCP();                // сфера и подпись TCP
+
+  // --- общие ресурсы (дети root_, переживают удаление сущностей) ---
+  Qt3DRender::QMaterial* material(const QColor& color, float alpha = 1.0f, bool alphaBlend = false);
+
+  // --- билдеры примитивов (меш единичного размера) ---
+  Part makeSpherePart(const QColor& color, float alpha = 1.0f);
+  size_t makeTextLabel(const QString& text, const QColor& color);   // индекс в labels_
+
+  // --- расстановка примитивов ---
+  void placeCylinder(size_t slot, const QVector3D& origin, const QVector3D& dir,
+                     float length, float radius, const QColor& color);
+  void hideCylinder(size_t slot);
+  size_t cylinderSlots() const { return cylinders_ ? cylinders_->size() : cylinderParts_.size(); }
+  void uploadCylinders() { if (cylinders_) cylinders_->upload(); }
+  void placeSphere(Part& p, const QVector3D& center, float radius);
+  void placeLabel(size_t label, const QVector3D& pos, float scale);
+  static void hide(Part& p) { if (p.entity) p.entity->setEnabled(false); }
 
   // --- математика/утилиты ---
-  static QQuaternion rotationFromYTo(const QVector3D& dir);
   static QQuaternion billboardUpright(const QVector3D& toCam, const QVector3D& camUp);
   static QVector3D toVec3(double x, double y, double z) { return QVector3D(float(x), float(y), float(z)); }
   static bool closestPointsOnLines(const QVector3D& p1, const QVector3D& u,
@@ -111,6 +137,31 @@ private:
 
   // Данные
   Results  results_;
+  Results  prev_;                  // предыдущий setData: по нему ищем изменившиеся кадры
+
+  // Пул сцены
+  bool sceneReady_ = false;
+  bool instanced_ = true;            // false — RHI-рендерер: цилиндры отдельными сущностями
+  InstancedCylinders* cylinders_ = nullptr;
+  struct CylinderPart {
+    Part part;
+    Qt3DRender::QMaterial* material = nullptr;
+  };
+  std::vector<CylinderPart> cylinderParts_;   // только без инстансинга; сущности создаются лениво
+  Part tcpSphere_;
+  size_t baseLabels_[3] = {0, 0, 0};
+  size_t tcpLabel_ = 0;
+
+  // Общие меши и кэш материалов
+  struct MaterialSlot {
+    QRgb rgb;
+    float alpha;
+    bool alphaBlend;
+    Qt3DRender::QMaterial* material;
+  };
+  Qt3DExtras::QSphereMesh*   unitSphere_   = nullptr;   // радиус 1
+  Qt3DExtras::QCylinderMesh* unitCylinder_ = nullptr;   // радиус 1, длина 1 (только без инстансинга)
+  std::vector<MaterialSlot>  materials_;
 
   // Стиль/масштаб
   float axisRadius_  = 0.01f;
@@ -130,5 +181,8 @@ private:
 
   Qt3DLogic::QFrameAction* frameAction_ = nullptr;
   std::vector<TextBillboard> labels_;      // все текстовые ярлыки
-  void onFrameUpdate(float dt);            // обновление отступа к камере
+  void onFrameUpdate(float dt);            // обновление отступа к камере (только если камера/подписи сдвинулись)
+  QVector3D labelCamPos_;                  // камера, под которую развёрнуты подписи
+  QVector3D labelCamUp_;
+  bool labelsDirty_ = true;                // placeLabel сдвинул подпись
 };
@@ -0,0 +1,52 @@
+#include "results_soa.h"
+
+void ResultsSoA::resize(size_t samples, size_t framesPerSample, Content content) {
+  samples_ = samples;
+  frames_ = framesPerSample;
+  content_ = content;
+  padded_ = (samples + 7) & ~size_t(7);
+
+  const size_t lines = size_t(fields()) * frames_ * (padded_ / 8);
+  if (data_.size() < lines) data_.resize(lines);
+}
+
+Interp ResultsSoA::frame(size_t sample, size_t frameIndex) const {
+  Interp out{};
+  double* dst = &out.x;
+  for (int c = 0; c < fields(); ++c) dst[c] = column(c, frameIndex)[sample];
+  return out;
+}
+
+void ResultsSoA::setFrame(size_t sample, size_t frameIndex, const Interp& f) {
+  const double* src = &f.x;
+  for (int c = 0; c < fields(); ++c) column(c, frameIndex)[sample] = src[c];
+}
+
+void ResultsSoA::assign(const Results& frames, size_t samples, Core::BatchOutput mode) {
+  if (samples == 0) { clear(); return; }
+  const size_t perSample = (mode == Core::BatchOutput::TcpOnly) ? 1 : frames.size() / samples;
+  resize(samples, perSample);
+
+  // По столбцам: запись в каждый столбец — подряд
+  for (size_t fr = 0; fr < perSample; ++fr) {
+    for (int c = 0; c < kFields; ++c) {
+      double* dst = column(c, fr);
+      for (size_t i = 0; i < samples; ++i) dst[i] = (&frames[i * perSample + fr].x)[c];
+    }
+  }
+}
+
+void ResultsSoA::toResults(Results& out) const {
+  out.assign(samples_ * frames_, Interp{});
+  for (size_t fr = 0; fr < frames_; ++fr) {
+    for (int c = 0; c < fields(); ++c) {
+      const double* src = column(c, fr);
+      for (size_t i = 0; i < samples_; ++i) (&out[i * frames_ + fr].x)[c] = src[i];
+    }
+  }
+}
+
+void ResultsSoA::sampleResults(size_t sample, Results& out) const {
+  out.resize(frames_);
+  for (size_t fr = 0; fr < frames_; ++fr) out[fr] = frame(sample, fr);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "core.h"
+#include <cstddef>
+#include <vector>
+
+// Результаты пакетной FK в виде структуры массивов: свой столбец на каждую компоненту Interp.
+// Столбец (field, frame) — значения всех выборок подряд, с границы 64 байт и с запасом до
+// кратного 8 (ширина AVX-512): ядро FkSimd пишет в него целыми регистрами, а проход,
+// которому нужны только позиции TCP, читает 3 плотных столбца вместо 12 double на кадр.
+//
+// Адрес компоненты: column(field, 0)[sample * sampleStride() + frame * frameStride()].
+// Раскладка та же, что у столбцов Trajectory::Kind::Results, только с выравниванием.
+class ResultsSoA {
+public:
+  // Порядок полей — как в Interp
+  enum Field { X, Y, Z, XX, XY, XZ, YX, YY, YZ, ZX, ZY, ZZ };
+  static constexpr int kFields = 12;
+
+  // Что хранить: кадр целиком или только позицию (X, Y, Z). Для Positions пакетная FK
+  // не ортонормирует оси вовсе, а столбцов осей нет (column() вернёт nullptr).
+  enum class Content { Frames, Positions };
+
+  // framesPerSample — как у пакетной FK: dof (AllFrames) или 1 (TcpOnly).
+  // Память переиспользуется, если хватает уже выделенной
+  void resize(size_t samples, size_t framesPerSample, Content content = Content::Frames);
+  void clear() { samples_ = frames_ = padded_ = 0; }
+
+  size_t samples() const { return samples_; }
+  size_t framesPerSample() const { return frames_; }
+  Content content() const { return content_; }
+  bool hasAxes() const { return content_ == Content::Frames; }
+  int fields() const { return hasAxes() ? kFields : 3; }
+
+  // Шаги в double внутри столбца поля
+  size_t sampleStride() const { return 1; }
+  size_t frameStride() const { return padded_; }
+
+  // Столбец поля field кадра frame (samples значений); nullptr — поля нет (Positions)
+  double* column(int field, size_t frame) {
+    return (field < fields()) ? base() + (size_t(field) * frames_ + frame) * padded_ : nullptr;
+  }
+  const double* column(int field, size_t frame) const {
+    return (field < fields()) ? base() + (size_t(field) * frames_ + frame) * padded_ : nullptr;
+  }
+
+  // Один кадр (оси — нули, если их нет) / записать кадр
+  Interp frame(size_t sample, size_t frameIndex) const;
+  void setFrame(size_t sample, size_t frameIndex, const Interp& f);
+
+  // ---- Адаптеры к Results ----
+  // Из раскладки пакетной FK (AllFrames: N*dof, TcpOnly: N)
+  void assign(const Results& frames, size_t samples, Core::BatchOutput mode);
+  // В ту же раскладку
+  void toResults(Results& out) const;
+  // Кадры одной выборки — как у Core::computeForwardKinematics (Visual::setComputed, Render3D::setData)
+  void sampleResults(size_t sample, Results& out) const;
+
+private:
+  struct alignas(64) Line { double v[8]; };
+
+  double* base() { return data_.empty() ? nullptr : data_.front().v; }
+  const double* base() const { return data_.empty() ? nullptr : data_.front().v; }
+
+  std::vector<Line> data_;
+  size_t samples_ = 0;
+  size_t frames_ = 0;
+  size_t padded_ = 0;   // samples_, округлённое вверх до кратного 8
+  Content content_ = Content::Frames;
+};
@@ -0,0 +1,1524 @@
+// robotdh_bench — замеры кинематики: от приватной математики Core до сквозного пути GUI.
+//
+//   robotdh_bench [--dof 3,6,12,24] [--min-time SEC] [--filter SUBSTR] [--output FILE|-]
+//                 [--check [--cli PATH]]
+//
+// Выход (--output, по умолчанию stdout): JSON, по записи на замер —
+//   name, dof, iterations, ns_per_op, allocs_per_op, configs_per_s.
+// --check — вместо замеров только проверки точности (массив "checks": max_error, bound, passed);
+//   код возврата 1, если хоть одна не прошла. --cli — путь к robotdh_cli для проверок cli.*
+//   (по умолчанию — рядом с robotdh_bench).
+// Сводка для человека — в stderr. Сравнение сборок — diff/скрипт по JSON.
+//
+// Группы:
+//   core.*      — Core: makeA, mul, composeAll, interpretOne, computeForwardKinematics
+//   coref.*     — то же во float (CoreF)
+//   compiled.*  — CompiledChain: одна конфигурация; .batch/.poses — блок kBatch (Interp / Pose)
+//   fixed.*     — ConstChain<Presets::kTZ6> (только dof = 6)
+//   simd.*      — FkSimd::computeBatch, блок kBatch конфигураций (.poly* — sincos из fast_trig.h;
+//                 .soa* — выход в ResultsSoA, .pos — только позиции)
+//   bulk.*      — Bulk::forwardKinematics / Bulk::jacobians на ThreadPool (только --check)
+//   cli.*       — robotdh_cli отдельным процессом: CSV -> FK -> CSV (только --check)
+//   collision.* — Collision::Checker по капсулам звеньев: одна поза / пакет kBatch поз
+//   playback.*  — TrajectoryPlayer::tick: доля потока GUI при воспроизведении (FK — в фоне)
+//   gui.*       — Visual::readTable -> FK -> Render3D::setData на offscreen-сцене
+//                 (только в сборке с GUI, см. bench_gui.cpp)
+//
+// Счётчик аллокаций в этой цели включён всегда (объект robotdh_alloc_counter подключается
+// независимо от CMake-опции ROBOTDH_ALLOC_COUNTER).
+
+#include "bench_harness.h"
+#include "bulk_eval.h"
+#include "core.h"
+#include "collision.h"
+#include "compiled_chain.h"
+#include "fixed_chain.h"
+#include "fk_simd.h"
+#include "ik.h"
+#include "jacobian.h"
+#include "presets.h"
+#include "results_soa.h"
+#include "trajectory_file.h"
+#include "trajectory_player.h"
+#include "workspace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
+
+#if defined(ROBOTDH_BENCH_GUI)
+// bench_gui.cpp: поднимает QApplication (offscreen) и замеряет gui.*
+void runGuiBenchmarks(Bench::Runner& run, int argc, char** argv, const std::vector<size_t>& dofs);
+#endif
+
+// Доступ к приватной математике Core (friend в core.h)
+struct CoreBenchAccess {
+  static void makeA(double t, double a, double d, double al, double A[4][4]) { Core::makeA(t, a, d, al, A); }
+  static void mul(const double L[4][4], const double R[4][4], double O[4][4]) { Core::mul(L, R, O); }
+  static void composeAll(const Snapshot& s, std::vector<std::array<double,16>>& T) { Core::composeFrom(s, 0, T); }
+};
+
+namespace {
+
+constexpr size_t kBatch = 4096;
+
+struct Options {
+  std::vector<size_t> dofs{3, 6, 12, 24};
+  Bench::Config bench;
+  std::string outputPath = "-";
+  std::string cliPath;             // --check: robotdh_cli; пусто — рядом с robotdh_bench
+  std::string childRssFile;        // служебный режим проверки cli.memory (см. checkCli)
+  bool check = false;
+};
+
+void usage() {
+  std::fprintf(stderr,
+    "usage: robotdh_bench [--dof 3,6,12,24] [--min-time SEC] [--filter SUBSTR] [--output FILE|-]\n"
+    "                     [--check [--cli PATH]]\n");
+}
+
+bool parseDofs(const std::string& v, std::vector<size_t>& out) {
+  out.clear();
+  const char* p = v.c_str();
+  while (*p) {
+    char* end = nullptr;
+    const unsigned long long n = std::strtoull(p, &end, 10);
+    if (end == p || n == 0) return false;
+    out.push_back(static_cast<size_t>(n));
+    p = (*end == ',') ? end + 1 : end;
+    if (end == p && *p) return false;
+  }
+  return !out.empty();
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    auto value = [&](std::string& dst) {
+      if (i + 1 >= argc) return false;
+      dst = argv[++i];
+      return true;
+    };
+    std::string v;
+    if      (a == "--dof")      { if (!value(v) || !parseDofs(v, o.dofs)) return false; }
+    else if (a == "--min-time") { if (!value(v)) return false; o.bench.minTimeSec = std::atof(v.c_str()); }
+    else if (a == "--filter")   { if (!value(o.bench.filter)) return false; }
+    else if (a == "--output")   { if (!value(o.outputPath)) return false; }
+    else if (a == "--check")    { o.check = true; }
+    else if (a == "--cli")      { if (!value(o.cliPath)) return false; }
+    else if (a == "--child-rss") { if (!value(o.childRssFile)) return false; }
+    else return false;
+  }
+  return o.bench.minTimeSec > 0.0;
+}
+
+// Цепь нужной длины: звенья ТЗ по кругу (без вырожденных нулевых звеньев Presets::Default)
+Snapshot makeChain(size_t dof) {
+  Snapshot s(dof);
+  for (size_t i = 0; i < dof; ++i) s[i] = Presets::kTZ6[i % Presets::kTZ6Dof];
+  return s;
+}
+
+std::vector<double> randomThetas(size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> U(-180.0, 180.0);
+  std::vector<double> th(count);
+  for (double& t : th) t = U(rng);
+  return th;
+}
+
+// Звенья всех видов, которые различают быстрые пути (FixedDH::AlphaKind, нулевые a/d):
+// alpha — 0, +90°, -90° или произвольный; a и d — ноль или случайная длина
+Snapshot mixedChain(size_t dof, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> L(-0.8, 0.8), A(-3.0, 3.0);
+  const double halfPi = Presets::kPi / 2.0;
+  Snapshot s(dof);
+  for (size_t i = 0; i < dof; ++i) {
+    const size_t kind = (i + seed) % 4;
+    s[i].alpha_rad = kind == 0 ? 0.0 : kind == 1 ? halfPi : kind == 2 ? -halfPi : A(rng);
+    s[i].a_m = (i / 4) % 2 ? L(rng) : 0.0;
+    s[i].d_m = (i / 8) % 2 ? 0.0 : L(rng);
+  }
+  return s;
+}
+
+double chainReach(const Snapshot& chain) {
+  double reach = 0.0;
+  for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+  return reach;
+}
+
+// Эталон: экземпляр Core с полной композицией 4x4 на каждую конфигурацию
+// (Core::computeForwardKinematicsBatch для double идёт через CompiledChain — не годится)
+Results coreReference(const Snapshot& chain, const double* thetas_deg, size_t samples) {
+  const size_t dof = chain.size();
+  Results all(samples * dof), frames;
+  Snapshot s = chain;
+  for (size_t i = 0; i < samples; ++i) {
+    for (size_t j = 0; j < dof; ++j) s[j].theta_deg = thetas_deg[i * dof + j];
+    Core core;
+    core.setInput(s);
+    core.computeForwardKinematics(frames);
+    std::copy(frames.begin(), frames.end(), all.begin() + i * dof);
+  }
+  return all;
+}
+
+// Максимум |a - b| по 12 полям кадра
+double frameError(const Interp& a, const Interp& b) {
+  double e = 0.0;
+  for (int c = 0; c < 12; ++c) e = std::max(e, std::fabs((&a.x)[c] - (&b.x)[c]));
+  return e;
+}
+
+// Допуск двух путей FK с разным порядком операций: 4 ulp на звено от вылета цепи
+double orderBound(size_t dof, double reach) {
+  return 4.0 * double(dof) * 2.220446049250313e-16 * std::max(1.0, reach);
+}
+
+// ---- Приватная математика Core (от длины цепи не зависит) ----
+void benchCoreMath(Bench::Runner& run) {
+  double A[4][4], B[4][4], C[4][4];
+  double theta = 0.3;
+  run.measure("core.makeA", 0, 0.0, [&] {
+    CoreBenchAccess::makeA(theta, 0.59, 0.16, 1.5707963267948966, A);
+    theta += 1e-3;
+    Bench::keep(A);
+  });
+
+  CoreBenchAccess::makeA(0.4, 0.8, 0.193, 0.0, A);
+  CoreBenchAccess::makeA(-1.1, 0.0, 0.25, 1.5707963267948966, B);
+  run.measure("core.mul", 0, 0.0, [&] {
+    CoreBenchAccess::mul(A, B, C);
+    Bench::keep(C);
+    A[0][3] += 1e-9;
+  });
+
+  std::vector<std::array<double,16>> T;
+  CoreBenchAccess::composeAll(makeChain(6), T);
+  std::array<double,16> flat = T.back();
+  run.measure("core.interpretOne", 0, 0.0, [&] {
+    const Interp it = Core::interpretOne(flat);
+    Bench::keep(it);
+    flat[3] += 1e-9;
+  });
+}
+
+// ---- Полная FK по длине цепи ----
+void benchDof(Bench::Runner& run, size_t dof) {
+  const Snapshot chain = makeChain(dof);
+  const std::vector<double> thetas = randomThetas(kBatch * dof, 42u + unsigned(dof));
+
+  {
+    Snapshot s = chain;
+    std::vector<std::array<double,16>> T;
+    run.measure("core.composeAll", dof, 1.0, [&] {
+      s[0].theta_deg += 1e-3;
+      CoreBenchAccess::composeAll(s, T);
+      Bench::keep(T.back());
+    });
+  }
+
+  {
+    Core core;
+    core.setInput(chain);
+    Results out;
+    bool flip = false;
+
+    // Первое звено меняется каждый раз — пересчитывается вся цепь
+    run.measure("core.fk.full", dof, 1.0, [&] {
+      core.setJointTheta(0, (flip = !flip) ? 10.0 : 20.0);
+      core.computeForwardKinematics(out);
+      Bench::keep(out.back());
+    });
+
+    // Меняется последнее звено — работает кэш префикса
+    run.measure("core.fk.incremental", dof, 1.0, [&] {
+      core.setJointTheta(dof - 1, (flip = !flip) ? 10.0 : 20.0);
+      core.computeForwardKinematics(out);
+      Bench::keep(out.back());
+    });
+
+    // Как в App::onCalculateClicked: снимок целиком + Results по значению
+    Snapshot s = chain;
+    run.measure("core.fk.snapshot", dof, 1.0, [&] {
+      s[0].theta_deg = (flip = !flip) ? 10.0 : 20.0;
+      core.setInput(s);
+      Results r = core.computeForwardKinematics();
+      Bench::keep(r.back());
+    });
+  }
+
+  {
+    CoreF core;
+    core.setInput(chain);
+    ResultsF out;
+    bool flip = false;
+    run.measure("coref.fk.full", dof, 1.0, [&] {
+      core.setJointTheta(0, (flip = !flip) ? 10.0 : 20.0);
+      core.computeForwardKinematics(out);
+      Bench::keep(out.back());
+    });
+    run.measure("coref.batch.all", dof, double(kBatch), [&] {
+      CoreF::computeForwardKinematicsBatch(chain, thetas.data(), kBatch, out);
+      Bench::keep(out.back());
+    });
+  }
+
+  {
+    const CompiledChain cc(chain);
+    Results out;
+    size_t i = 0;
+    run.measure("compiled.compute", dof, 1.0, [&] {
+      cc.compute(thetas.data() + (i++ % kBatch) * dof, out);
+      Bench::keep(out.back());
+    });
+    run.measure("compiled.tcp", dof, 1.0, [&] {
+      const Interp tcp = cc.computeTcp(thetas.data() + (i++ % kBatch) * dof);
+      Bench::keep(tcp);
+    });
+
+    // Позиция + кватернион (pose.h) вместо Interp
+    Poses poses;
+    run.measure("compiled.poses.all", dof, double(kBatch), [&] {
+      cc.computeBatchPoses(thetas.data(), kBatch, poses);
+      Bench::keep(poses.back());
+    });
+    run.measure("compiled.batch.all", dof, double(kBatch), [&] {
+      cc.computeBatch(thetas.data(), kBatch, out);
+      Bench::keep(out.back());
+    });
+
+    // Тот же интерфейс на кватернионах (quat_chain.h)
+    const CompiledChain qc(chain, CompiledChain::Backend::Quaternion);
+    run.measure("compiled.quat.batch.all", dof, double(kBatch), [&] {
+      qc.computeBatch(thetas.data(), kBatch, out);
+      Bench::keep(out.back());
+    });
+    run.measure("compiled.quat.poses.all", dof, double(kBatch), [&] {
+      qc.computeBatchPoses(thetas.data(), kBatch, poses);
+      Bench::keep(poses.back());
+    });
+  }
+
+  if (dof == Presets::kTZ6Dof) {
+    ConstChain<Presets::kTZ6>::Thetas th{};
+    size_t i = 0;
+    run.measure("fixed.tcp", dof, 1.0, [&] {
+      const double* src = thetas.data() + (i++ % kBatch) * dof;
+      for (size_t j = 0; j < dof; ++j) th[j] = src[j];
+      const Interp tcp = ConstChain<Presets::kTZ6>::tcp(th);
+      Bench::keep(tcp);
+    });
+  }
+
+  {
+    Results out;
+    run.measure("simd.batch.tcp", dof, double(kBatch), [&] {
+      FkSimd::computeBatch(chain, thetas.data(), kBatch, out, Core::BatchOutput::TcpOnly);
+      Bench::keep(out.back());
+    });
+    run.measure("simd.batch.all", dof, double(kBatch), [&] {
+      FkSimd::computeBatch(chain, thetas.data(), kBatch, out, Core::BatchOutput::AllFrames);
+      Bench::keep(out.back());
+    });
+    // Полиномиальный sincos (fast_trig.h)
+    const struct { const char* name; FastTrig::Accuracy trig; } levels[] = {
+      { "simd.batch.tcp.polyfull", FastTrig::Accuracy::PolyFull },
+      { "simd.batch.tcp.poly1e9",  FastTrig::Accuracy::Poly1e9 },
+      { "simd.batch.tcp.poly1e6",  FastTrig::Accuracy::Poly1e6 },
+    };
+    for (const auto& lv : levels) {
+      run.measure(lv.name, dof, double(kBatch), [&] {
+        FkSimd::computeBatch(chain, thetas.data(), kBatch, out, Core::BatchOutput::TcpOnly,
+                             FkSimd::detectIsa(), lv.trig);
+        Bench::keep(out.back());
+      });
+    }
+  }
+
+  {
+    ResultsSoA soa;
+    run.measure("simd.soa.tcp", dof, double(kBatch), [&] {
+      FkSimd::computeBatch(chain, thetas.data(), kBatch, soa, Core::BatchOutput::TcpOnly);
+      Bench::keep(soa.column(ResultsSoA::ZZ, 0)[kBatch - 1]);
+    });
+    run.measure("simd.soa.tcp.pos", dof, double(kBatch), [&] {
+      FkSimd::computeBatch(chain, thetas.data(), kBatch, soa, Core::BatchOutput::TcpOnly,
+                           ResultsSoA::Content::Positions);
+      Bench::keep(soa.column(ResultsSoA::Z, 0)[kBatch - 1]);
+    });
+    run.measure("simd.soa.all", dof, double(kBatch), [&] {
+      FkSimd::computeBatch(chain, thetas.data(), kBatch, soa, Core::BatchOutput::AllFrames);
+      Bench::keep(soa.column(ResultsSoA::ZZ, dof - 1)[kBatch - 1]);
+    });
+  }
+
+  {
+    Results frames;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), kBatch, frames);
+    Collision::Checker checker;
+    size_t i = 0;
+    run.measure("collision.query", dof, 1.0, [&] {
+      const Collision::Result r = checker.query(frames.data() + (i++ % kBatch) * dof, dof);
+      Bench::keep(r.distance);
+    });
+    run.measure("collision.collides", dof, 1.0, [&] {
+      Bench::keep(checker.collides(frames.data() + (i++ % kBatch) * dof, dof));
+    });
+    std::vector<Collision::Result> res;
+    run.measure("collision.batch", dof, double(kBatch), [&] {
+      Collision::checkBatch(nullptr, frames.data(), kBatch, dof, Collision::Options{}, res);
+      Bench::keep(res.back().distance);
+    });
+  }
+
+  {
+    // Траектория из kBatch выборок по кругу; ns_per_op — время потока GUI на кадр
+    TrajectoryPlayer player;
+    player.load(chain, thetas.data(), kBatch, 1000.0);
+    player.setLoop(true);
+    player.play();
+    Results frame;
+    run.measure("playback.tick", dof, 1.0, [&] {
+      Bench::keep(player.tick(frame));
+    });
+  }
+}
+
+// ---- Точность: CoreF против Core (допуск — FloatBound в core.h) ----
+void checkFloat(Bench::Runner& run) {
+  constexpr size_t kSamples = 2000;
+  const size_t dofs[] = { 1, 2, 3, 6, 12, 24, 48, FloatBound::kMaxCheckedDof };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    double reach = 0.0;
+    for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 7u + unsigned(dof));
+    Results ref;
+    ResultsF f;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), kSamples, ref);
+    CoreF::computeForwardKinematicsBatch(chain, thetas.data(), kSamples, f);
+
+    double pos = 0.0, axis = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+      const double* r = &ref[i].x;
+      const float* q = &f[i].x;
+      const double dx = r[0] - q[0], dy = r[1] - q[1], dz = r[2] - q[2];
+      pos = std::max(pos, std::sqrt(dx*dx + dy*dy + dz*dz));
+      for (int c = 3; c < 12; ++c) axis = std::max(axis, std::fabs(r[c] - double(q[c])));
+    }
+    run.check("float.position", dof, pos, FloatBound::position(dof, reach));
+    run.check("float.axis", dof, axis, FloatBound::axis(dof));
+  }
+}
+
+// ---- FixedChain<N> / ConstChain против экземпляра Core ----
+template <size_t N>
+double fixedChainError(const Snapshot& chain, const std::vector<double>& thetas, size_t samples) {
+  JointDH links[N];
+  std::copy(chain.begin(), chain.end(), links);
+  const FixedChain<N> fc(links);
+  const Results ref = coreReference(chain, thetas.data(), samples);
+  typename FixedChain<N>::Thetas th;
+  typename FixedChain<N>::Frames frames;
+  double err = 0.0;
+  for (size_t i = 0; i < samples; ++i) {
+    std::copy(thetas.begin() + i * N, thetas.begin() + (i + 1) * N, th.begin());
+    fc.compute(th, frames);
+    for (size_t k = 0; k < N; ++k) err = std::max(err, frameError(frames[k], ref[i * N + k]));
+    err = std::max(err, frameError(fc.tcp(th), ref[i * N + N - 1]));
+  }
+  return err;
+}
+
+void checkFixedChain(Bench::Runner& run) {
+  constexpr size_t kSamples = 500;
+  constexpr size_t N = Presets::kTZ6Dof;
+
+  {
+    const Snapshot chain = makeChain(N);
+    const std::vector<double> thetas = randomThetas(kSamples * N, 83u);
+    const Results ref = coreReference(chain, thetas.data(), kSamples);
+    ConstChain<Presets::kTZ6>::Thetas th;
+    ConstChain<Presets::kTZ6>::Frames frames;
+    double err = 0.0;
+    for (size_t i = 0; i < kSamples; ++i) {
+      std::copy(thetas.begin() + i * N, thetas.begin() + (i + 1) * N, th.begin());
+      ConstChain<Presets::kTZ6>::compute(th, frames);
+      for (size_t k = 0; k < N; ++k) err = std::max(err, frameError(frames[k], ref[i * N + k]));
+      err = std::max(err, frameError(ConstChain<Presets::kTZ6>::tcp(th), ref[i * N + N - 1]));
+    }
+    run.check("fixed.const", N, err, orderBound(N, chainReach(chain)));
+    run.check("fixed.chain", N, fixedChainError<N>(chain, thetas, kSamples), orderBound(N, chainReach(chain)));
+  }
+
+  // Геометрия в рантайме: все виды alpha и нулевые/ненулевые a, d
+  {
+    const Snapshot chain = mixedChain(6, 89u);
+    const std::vector<double> thetas = randomThetas(kSamples * 6, 97u);
+    run.check("fixed.chain.mixed", 6, fixedChainError<6>(chain, thetas, kSamples), orderBound(6, chainReach(chain)));
+  }
+  {
+    const Snapshot chain = mixedChain(16, 101u);
+    const std::vector<double> thetas = randomThetas(kSamples * 16, 103u);
+    run.check("fixed.chain.mixed", 16, fixedChainError<16>(chain, thetas, kSamples), orderBound(16, chainReach(chain)));
+  }
+}
+
+// ---- Инкрементальный Core: кэш префикса после setJointTheta/setInput против полного пересчёта ----
+// Префикс берётся из тех же матриц, что посчитал бы полный расчёт, — совпадение побитное.
+void checkIncremental(Bench::Runner& run) {
+  constexpr int kSteps = 3000;
+  const size_t dofs[] = { 1, 6, 24 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = mixedChain(dof, 107u + unsigned(dof));
+    std::mt19937 rng(109u + unsigned(dof));
+    std::uniform_real_distribution<double> U(-180.0, 180.0);
+
+    Core core;
+    core.setInput(chain);
+    Results inc, full;
+    core.computeForwardKinematics(inc);
+
+    double err = 0.0;
+    for (int step = 0; step < kSteps; ++step) {
+      Snapshot s = core.input();
+      switch (step % 6) {
+      case 0:  core.setJointTheta(0, U(rng)); break;                              // первый сустав
+      case 1:  core.setJointTheta(rng() % dof, U(rng)); break;
+      case 2:  core.setJointTheta(dof - 1, U(rng));                              // два подряд,
+               core.setJointTheta(rng() % dof, U(rng)); break;                   // второй — раньше
+      case 3:  core.setJointTheta(dof, U(rng)); break;                            // вне цепи
+      case 4:  s[rng() % dof].theta_deg = U(rng); core.setInput(s); break;
+      default: s[rng() % dof].d_m += 0.01; core.setInput(s); break;              // геометрия
+      }
+      core.computeForwardKinematics(inc);
+
+      Core fresh;
+      fresh.setInput(core.input());
+      fresh.computeForwardKinematics(full);
+      if (inc.size() != full.size()) { err = HUGE_VAL; break; }
+      for (size_t k = 0; k < dof; ++k) err = std::max(err, frameError(inc[k], full[k]));
+    }
+    run.check("core.incremental", dof, err, 0.0);
+  }
+}
+
+// ---- Аллокации: Core::computeForwardKinematics(out) в установившемся режиме — ноль ----
+// Сначала счётчик должен заметить заведомую аллокацию (перегрузка с возвратом по значению),
+// иначе ноль ниже ничего не доказывает.
+void checkAllocs(Bench::Runner& run) {
+  constexpr int kCalls = 1000;
+  const size_t dofs[] = { 1, 6, 24, 64 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    Core core;
+    core.setInput(chain);
+
+    double counterDead = 1.0;
+    {
+      AllocCounter::Scope scope;
+      const Results byValue = core.computeForwardKinematics();
+      Bench::keep(byValue.back());
+      if (AllocCounter::enabled() && scope.allocations() > 0) counterDead = 0.0;
+    }
+    run.check("alloc.counter", dof, counterDead, 0.0);
+
+    Results out;
+    core.computeForwardKinematics(out);   // прогрев: буфер и кэш выросли до dof
+    AllocCounter::Scope scope;
+    for (int i = 0; i < kCalls; ++i) {
+      core.setJointTheta(size_t(i) % dof, (i % 2) ? 10.0 : 20.0);
+      core.computeForwardKinematics(out);
+    }
+    Bench::keep(out.back());
+    run.check("alloc.core.fk", dof, double(scope.allocations()) / kCalls, 0.0);
+  }
+}
+
+// ---- CompiledChain (разреженные шаги) против экземпляра Core: все виды alpha, нулевые a/d ----
+void checkCompiled(Bench::Runner& run) {
+  constexpr size_t kSamples = 500;
+  const size_t dofs[] = { 1, 4, 6, 16, 64 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = mixedChain(dof, 113u + unsigned(dof));
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 127u + unsigned(dof));
+    const Results ref = coreReference(chain, thetas.data(), kSamples);
+    const CompiledChain cc(chain);
+
+    double one = 0.0, batch = 0.0, tcp = 0.0, own = 0.0;
+    Results frames, all, tcps;
+    for (size_t i = 0; i < kSamples; ++i) {
+      cc.compute(thetas.data() + i * dof, frames);
+      for (size_t k = 0; k < dof; ++k) one = std::max(one, frameError(frames[k], ref[i * dof + k]));
+      tcp = std::max(tcp, frameError(cc.computeTcp(thetas.data() + i * dof), ref[i * dof + dof - 1]));
+    }
+    cc.computeBatch(thetas.data(), kSamples, all);
+    cc.computeBatch(thetas.data(), kSamples, tcps, Core::BatchOutput::TcpOnly);
+    for (size_t i = 0; i < ref.size(); ++i) batch = std::max(batch, frameError(all[i], ref[i]));
+    for (size_t i = 0; i < kSamples; ++i) tcp = std::max(tcp, frameError(tcps[i], ref[i * dof + dof - 1]));
+
+    // Углы по умолчанию — из Snapshot, как у Core::computeForwardKinematics
+    Snapshot posed = chain;
+    for (size_t j = 0; j < dof; ++j) posed[j].theta_deg = thetas[j];
+    const Results posedRef = coreReference(posed, thetas.data(), 1);
+    CompiledChain(posed).computeForwardKinematics(frames);
+    for (size_t k = 0; k < dof; ++k) own = std::max(own, frameError(frames[k], posedRef[k]));
+
+    const double bound = orderBound(dof, chainReach(chain));
+    run.check("compiled.compute", dof, one, bound);
+    run.check("compiled.tcp", dof, tcp, bound);
+    run.check("compiled.batch", dof, batch, bound);
+    run.check("compiled.snapshot", dof, own, bound);
+  }
+}
+
+// ---- Точность: CompiledChain::Backend::Quaternion против Core ----
+void checkQuaternion(Bench::Runner& run) {
+  constexpr size_t kSamples = 2000;
+  const size_t dofs[] = { 1, 6, 24, 64, 512 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    double reach = 0.0;
+    for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+
+    const size_t n = (dof > 64) ? kSamples / 10 : kSamples;
+    const std::vector<double> thetas = randomThetas(n * dof, 13u + unsigned(dof));
+    Results ref, q;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), n, ref);
+    CompiledChain(chain, CompiledChain::Backend::Quaternion).computeBatch(thetas.data(), n, q);
+
+    double err = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+      const double* a = &ref[i].x;
+      const double* b = &q[i].x;
+      for (int c = 0; c < 12; ++c) err = std::max(err, std::fabs(a[c] - b[c]));
+    }
+    // Накопление округлений линейно по длине цепи; 4 ulp на звено с запасом
+    run.check("backend.quaternion", dof, err, 4.0 * double(dof) * 2.220446049250313e-16 * std::max(1.0, reach));
+  }
+}
+
+// ---- Позы (pose.h): кватернион Шеппарда туда-обратно и CompiledChain::computePoses против Core ----
+void checkPose(Bench::Runner& run) {
+  constexpr double kEps = 2.220446049250313e-16;
+
+  // Interp -> Pose -> Interp: случайные повороты и повороты около 180° (след ~ -1, qw ~ 0) —
+  // ветви Шеппарда с делением на qx/qy/qz. Сравниваются матрицы (q и -q при qw = 0 — один поворот).
+  {
+    std::mt19937 rng(71u);
+    std::normal_distribution<double> N(0.0, 1.0);
+    const double nearPi[] = { 0.0, 1e-12, 1e-8, 1e-4, 1e-2 };
+    double err = 0.0, unit = 0.0;
+    for (int i = 0; i < 20000; ++i) {
+      Pose q{ N(rng), N(rng), N(rng), N(rng), N(rng), N(rng), N(rng) };
+      if (i % 2) q.qw = nearPi[(i / 2) % 5] * (i % 4 == 1 ? 1.0 : -1.0);
+      if (i < 12) {                               // ровно 180° вокруг осей и диагоналей: след = -1
+        q.qw = 0.0;
+        q.qx = (i % 3 == 0); q.qy = (i % 3 == 1 || i >= 6); q.qz = (i % 3 == 2 || i >= 9);
+      }
+      PoseMath::normalize(q);
+      const Interp f = PoseMath::toInterp(q);
+      const Pose p = PoseMath::fromInterp(f);
+      const Interp g = PoseMath::toInterp(p);
+      for (int c = 0; c < 12; ++c) err = std::max(err, std::fabs((&f.x)[c] - (&g.x)[c]));
+      unit = std::max(unit, PoseMath::normError(p));
+    }
+    // Два преобразования, каждое — несколько ulp на элемент
+    run.check("pose.roundtrip", 0, err, 16.0 * kEps);
+    run.check("pose.roundtrip.norm", 0, unit, 4.0 * kEps);
+  }
+
+  // computePoses против Core (ортонормирует каждый кадр): позиция и оси; |q| без нормировки
+  constexpr size_t kSamples = 200;
+  const size_t dofs[] = { 1, 6, 24, 64, 512 };
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    double reach = 0.0;
+    for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+
+    const size_t n = (dof > 64) ? kSamples / 10 : kSamples;
+    const std::vector<double> thetas = randomThetas(n * dof, 79u + unsigned(dof));
+    Results ref;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), n, ref);
+    const CompiledChain cc(chain);
+    Poses batch;
+    cc.computeBatchPoses(thetas.data(), n, batch);
+
+    double pos = 0.0, axis = 0.0, drift = 0.0, batchErr = 0.0;
+    std::vector<Pose> poses(dof);
+    for (size_t i = 0; i < n; ++i) {
+      cc.computePoses(thetas.data() + i * dof, poses.data());
+      for (size_t k = 0; k < dof; ++k) {
+        const Interp& a = ref[i * dof + k];
+        const Interp b = PoseMath::toInterp(poses[k]);
+        for (int c = 0; c < 3; ++c) pos = std::max(pos, std::fabs((&a.x)[c] - (&b.x)[c]));
+        for (int c = 3; c < 12; ++c) axis = std::max(axis, std::fabs((&a.x)[c] - (&b.x)[c]));
+        drift = std::max(drift, PoseMath::normError(poses[k]));
+        const Pose& p = batch[i * dof + k];
+        for (int c = 0; c < 7; ++c) batchErr = std::max(batchErr, std::fabs((&p.x)[c] - (&poses[k].x)[c]));
+      }
+    }
+    run.check("pose.position", dof, pos, 1e-14 * std::max(1.0, reach));
+    run.check("pose.axis", dof, axis, 1e-14);
+    run.check("pose.drift", dof, drift, 3e-15);
+    run.check("pose.batch", dof, batchErr, 0.0);
+  }
+}
+
+// ---- ResultsSoA: выход ядра по столбцам совпадает с Results побитно, адаптеры — без потерь ----
+void checkSoa(Bench::Runner& run) {
+  constexpr size_t kSamples = 1001;   // не кратно ширине регистра — хвост блока тоже проверяется
+  const size_t dofs[] = { 1, 6, 24 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 17u + unsigned(dof));
+
+    for (int isa = 0; isa <= static_cast<int>(FkSimd::detectIsa()); ++isa) {
+      const FkSimd::Isa i = static_cast<FkSimd::Isa>(isa);
+      const std::string suffix = std::string(".") + FkSimd::isaName(i);
+      for (Core::BatchOutput mode : { Core::BatchOutput::AllFrames, Core::BatchOutput::TcpOnly }) {
+        Results ref, back;
+        ResultsSoA soa, pos, round;
+        FkSimd::computeBatch(chain, thetas.data(), kSamples, ref, mode, i);
+        FkSimd::computeBatch(chain, thetas.data(), kSamples, soa, mode, ResultsSoA::Content::Frames, i);
+        FkSimd::computeBatch(chain, thetas.data(), kSamples, pos, mode, ResultsSoA::Content::Positions, i);
+        soa.toResults(back);
+        round.assign(ref, kSamples, mode);
+
+        double err = (back.size() == ref.size()) ? 0.0 : 1.0;
+        double posErr = 0.0, roundErr = 0.0;
+        const size_t frames = soa.framesPerSample();
+        for (size_t k = 0; k < back.size() && k < ref.size(); ++k) {
+          const double* a = &ref[k].x;
+          const double* b = &back[k].x;
+          for (int c = 0; c < 12; ++c) err = std::max(err, std::fabs(a[c] - b[c]));
+
+          const Interp p = pos.frame(k / frames, k % frames);
+          const Interp r = round.frame(k / frames, k % frames);
+          for (int c = 0; c < 3; ++c) posErr = std::max(posErr, std::fabs(a[c] - (&p.x)[c]));
+          for (int c = 0; c < 12; ++c) roundErr = std::max(roundErr, std::fabs(a[c] - (&r.x)[c]));
+        }
+        const char* m = (mode == Core::BatchOutput::TcpOnly) ? ".tcp" : ".all";
+        run.check("soa.kernel" + std::string(m) + suffix, dof, err, 0.0);
+        run.check("soa.positions" + std::string(m) + suffix, dof, posErr, 0.0);
+        if (isa == 0) run.check(std::string("soa.assign") + m, dof, roundErr, 0.0);
+      }
+    }
+  }
+}
+
+// ---- Collision: обход BVH против перебора всех пар капсул ----
+void checkCollision(Bench::Runner& run) {
+  constexpr size_t kSamples = 2000;
+  const size_t dofs[] = { 2, 6, 24, 96 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 19u + unsigned(dof));
+    Results frames;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), kSamples, frames);
+
+    Collision::Checker checker;
+    double err = 0.0, verdict = 0.0;
+    for (size_t i = 0; i < kSamples; ++i) {
+      const Collision::Result r = checker.query(frames.data() + i * dof, dof);
+      const std::vector<Collision::Capsule>& caps = checker.capsules();
+      double brute = std::numeric_limits<double>::infinity();
+      for (size_t a = 0; a < caps.size(); ++a) {
+        for (size_t b = a + 1; b < caps.size(); ++b) {
+          if (std::abs(caps[a].group - caps[b].group) <= 1) continue;
+          brute = std::min(brute, Collision::segmentDistance(caps[a].a, caps[a].b, caps[b].a, caps[b].b)
+                                  - caps[a].r - caps[b].r);
+        }
+      }
+      if (std::isinf(brute) != std::isinf(r.distance)) err = 1.0;
+      else if (!std::isinf(brute)) err = std::max(err, std::fabs(brute - r.distance));
+      if (checker.collides(frames.data() + i * dof, dof) != (brute < 0.0)) verdict = 1.0;
+    }
+    run.check("collision.bvh", dof, err, 1e-12);
+    run.check("collision.verdict", dof, verdict, 0.0);
+  }
+}
+
+// ---- VoxelGrid: крайние индексы ключа и отказ за его пределами (без наложения на чужой воксель) ----
+void checkVoxelGrid(Bench::Runner& run) {
+  constexpr double kEdge = double(1 << 20);   // 21 бит со знаком: индексы [-2^20, 2^20)
+  VoxelGrid grid(1.0);
+  double bad = 0.0;
+
+  const double inside[][3] = { { kEdge - 0.5, 0.5, 0.5 }, { -kEdge, -kEdge, kEdge - 1.0 }, { 0.5, 0.5, 0.5 } };
+  for (const auto& p : inside) bad += !grid.add(p[0], p[1], p[2]);
+  // Было бы наложение: 2^21 + 0.5 по маске — воксель 0
+  const double outside[][3] = { { kEdge, 0.5, 0.5 }, { 0.5, -kEdge - 1.0, 0.5 }, { 2.0 * kEdge + 0.5, 0.5, 0.5 },
+                                { 1e30, 0.5, 0.5 }, { 0.5, 0.5, std::nan("") } };
+  for (const auto& p : outside) bad += grid.add(p[0], p[1], p[2]);
+
+  bad += (grid.countAt(0.5, 0.5, 0.5) != 1) + (grid.countAt(kEdge - 0.5, 0.5, 0.5) != 1);
+  bad += (grid.countAt(2.0 * kEdge + 0.5, 0.5, 0.5) != 0) + (grid.countAt(1e30, 0.0, 0.0) != 0);
+  bad += (grid.total() != 3) + (grid.outside() != 5) + (grid.occupied() != 3);
+  grid.forEach([&](int ix, int iy, int iz, uint32_t) {
+    double x, y, z;
+    grid.center(ix, iy, iz, x, y, z);
+    bad += (grid.countAt(x, y, z) != 1);
+  });
+  run.check("workspace.voxel.range", 0, bad, 0.0);
+}
+
+// ---- sampleWorkspace: габарит на известной цепи, детерминизм по seed, отказ при неверных пределах ----
+// Плоская цепь a = 1 и 0.5 м: TCP в кольце [0.5, 1.5] на z = 0; с theta2 = 0 и theta1 в [0, 90] —
+// четверть окружности радиуса 1.5. Одинаковая выборка — при любом числе потоков и повторе.
+void checkWorkspace(Bench::Runner& run) {
+  const Snapshot planar = { { 0.0, 1.0, 0.0, 0.0 }, { 0.0, 0.5, 0.0, 0.0 } };
+  constexpr double kEps = 1e-12;
+  double bad = 0.0;
+
+  WorkspaceOptions opt;
+  opt.samples = 20000;
+  opt.voxelSize = 0.02;
+  WorkspaceResult r = sampleWorkspace(planar, opt);
+  bad += !r.error.empty() + (r.samples != opt.samples) + (r.outside != 0);
+  bad += (r.minX < -1.5 - kEps) + (r.maxX > 1.5 + kEps) + (r.minY < -1.5 - kEps) + (r.maxY > 1.5 + kEps);
+  bad += (r.maxX < 1.49) + (r.minX > -1.49) + (std::fabs(r.minZ) > kEps) + (std::fabs(r.maxZ) > kEps);
+  const double half = opt.voxelSize * std::sqrt(3.0) * 0.5;   // центр вокселя — не дальше от точки
+  r.grid.forEach([&](int ix, int iy, int iz, uint32_t) {
+    double x, y, z;
+    r.grid.center(ix, iy, iz, x, y, z);
+    const double d = std::sqrt(x * x + y * y + z * z);
+    bad += (d < 0.5 - half) || (d > 1.5 + half);
+  });
+
+  opt.lowerDeg = { 0.0, 0.0 };
+  opt.upperDeg = { 90.0, 0.0 };
+  r = sampleWorkspace(planar, opt);
+  bad += !r.error.empty();
+  bad += (r.minX < -kEps) + (r.minY < -kEps) + (r.maxX > 1.5 + kEps) + (r.maxY > 1.5 + kEps);
+  bad += (r.maxX < 1.49) + (r.maxY < 1.49) + (r.minX > 0.01) + (r.minY > 0.01);
+  run.check("workspace.reach", planar.size(), bad, 0.0);
+
+  // Детерминизм: выборка не кратна пакету, 1 поток / несколько / повтор
+  const Snapshot chain = makeChain(6);
+  WorkspaceOptions det;
+  det.samples = 50003;
+  det.chunk = 1000;
+  det.rngSeed = 7;
+  auto same = [](const WorkspaceResult& a, const WorkspaceResult& b) {
+    bool eq = a.samples == b.samples && a.outside == b.outside && a.grid.occupied() == b.grid.occupied()
+           && a.minX == b.minX && a.minY == b.minY && a.minZ == b.minZ
+           && a.maxX == b.maxX && a.maxY == b.maxY && a.maxZ == b.maxZ;
+    a.grid.forEach([&](int ix, int iy, int iz, uint32_t n) {
+      double x, y, z;
+      a.grid.center(ix, iy, iz, x, y, z);
+      eq = eq && b.grid.countAt(x, y, z) == n;
+    });
+    return eq;
+  };
+  det.threads = 1;
+  const WorkspaceResult one = sampleWorkspace(chain, det);
+  det.threads = int(std::max(4u, std::thread::hardware_concurrency()));
+  const WorkspaceResult many = sampleWorkspace(chain, det);
+  const WorkspaceResult again = sampleWorkspace(chain, det);
+  det.rngSeed = 8;
+  const WorkspaceResult other = sampleWorkspace(chain, det);
+  double mismatch = (one.samples != det.samples) + !same(one, many) + !same(many, again) + same(one, other);
+  run.check("workspace.seed", chain.size(), mismatch, 0.0);
+
+  // Неверные параметры — ошибка без выборки
+  double accepted = 0.0;
+  const double nan = std::nan("");
+  const double inf = std::numeric_limits<double>::infinity();
+  const std::vector<double> lowers[] = { { 10.0, 0.0 }, { 0.0 }, { nan, 0.0 }, { -inf, 0.0 } };
+  const std::vector<double> uppers[] = { { 0.0, 0.0 },  { 0.0 }, { 0.0, 0.0 }, { 0.0, 0.0 } };
+  for (size_t k = 0; k < 4; ++k) {
+    WorkspaceOptions b;
+    b.samples = 100;
+    b.lowerDeg = lowers[k];
+    b.upperDeg = uppers[k];
+    const WorkspaceResult e = sampleWorkspace(planar, b);
+    accepted += e.error.empty() || e.samples != 0;
+  }
+  WorkspaceOptions zero;
+  zero.samples = 100;
+  zero.voxelSize = 0.0;
+  const WorkspaceResult e = sampleWorkspace(planar, zero);
+  accepted += e.error.empty() || e.samples != 0;
+  run.check("workspace.badoptions", planar.size(), accepted, 0.0);
+}
+
+// ---- Якобиан: столбцы против центральных разностей CompiledChain::computeTcp ----
+// Линейная часть — (p(+h) - p(-h)) / 2h, угловая — vee(R(+h) R(-h)^T) / 2h (кососимметричная
+// часть). Погрешность разностей ~ h^2 * вылет + eps * вылет / h, отсюда допуск.
+void checkJacobian(Bench::Runner& run) {
+  constexpr size_t kPoses = 40;
+  constexpr double kH = 1e-5;                         // шаг, рад
+  constexpr double kDeg = 180.0 / 3.14159265358979323846;
+  const size_t dofs[] = { 1, 2, 6, 24 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    double reach = 0.0;
+    for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+    const std::vector<double> thetas = randomThetas(kPoses * dof, 37u + unsigned(dof));
+
+    const JacobianEngine engine(chain);
+    Results frames;
+    std::vector<double> J, Jbatch;
+    engine.computeBatch(thetas.data(), kPoses, Jbatch);
+
+    double linErr = 0.0, angErr = 0.0, batchErr = 0.0;
+    std::vector<double> th(dof);
+    for (size_t i = 0; i < kPoses; ++i) {
+      const double* t0 = thetas.data() + i * dof;
+      engine.compute(t0, frames, J);
+      for (size_t r = 0; r < 6 * dof; ++r) batchErr = std::max(batchErr, std::fabs(J[r] - Jbatch[i * 6 * dof + r]));
+
+      for (size_t k = 0; k < dof; ++k) {
+        th.assign(t0, t0 + dof);
+        th[k] = t0[k] + kH * kDeg;
+        const Interp p = engine.chain().computeTcp(th.data());
+        th[k] = t0[k] - kH * kDeg;
+        const Interp m = engine.chain().computeTcp(th.data());
+
+        const double* col = J.data() + k * 6;
+        const double v[3] = { (p.x - m.x) / (2 * kH), (p.y - m.y) / (2 * kH), (p.z - m.z) / (2 * kH) };
+
+        // R = [X Y Z] по столбцам; W = R+ R-^T, w = vee(W - W^T) / 2 / 2h
+        const double Rp[3][3] = { { p.xx, p.yx, p.zx }, { p.xy, p.yy, p.zy }, { p.xz, p.yz, p.zz } };
+        const double Rm[3][3] = { { m.xx, m.yx, m.zx }, { m.xy, m.yy, m.zy }, { m.xz, m.yz, m.zz } };
+        double W[3][3];
+        for (int a = 0; a < 3; ++a)
+          for (int b = 0; b < 3; ++b)
+            W[a][b] = Rp[a][0] * Rm[b][0] + Rp[a][1] * Rm[b][1] + Rp[a][2] * Rm[b][2];
+        const double w[3] = { (W[2][1] - W[1][2]) / (4 * kH),
+                              (W[0][2] - W[2][0]) / (4 * kH),
+                              (W[1][0] - W[0][1]) / (4 * kH) };
+        for (int r = 0; r < 3; ++r) {
+          linErr = std::max(linErr, std::fabs(col[r] - v[r]));
+          angErr = std::max(angErr, std::fabs(col[3 + r] - w[r]));
+        }
+      }
+    }
+    run.check("jacobian.linear", dof, linErr, 1e-8 * std::max(1.0, reach));
+    run.check("jacobian.angular", dof, angErr, 1e-8);
+    run.check("jacobian.batch", dof, batchErr, 0.0);
+  }
+}
+
+// ---- Bulk: пул потоков против последовательных computeBatch, побитово ----
+// 1 исполнитель и несколько; число выборок не кратно куску (последний кусок неполный),
+// кусков больше, чем исполнителей (кража работы). Порядок выхода — по индексу выборки.
+void checkBulk(Bench::Runner& run) {
+  struct Case { size_t samples, grain; };
+  const Case cases[] = { { 1, Bulk::kDefaultGrain }, { 1000, 7 }, { 2 * Bulk::kDefaultGrain + 3, Bulk::kDefaultGrain } };
+  const int threads = int(std::max(4u, std::thread::hardware_concurrency()));
+  const size_t dofs[] = { 1, 6, 24 };
+
+  for (size_t dof : dofs) {
+    const CompiledChain chain(makeChain(dof));
+    const JacobianEngine engine(makeChain(dof));
+    double fkErr = 0.0, tcpErr = 0.0, jacErr = 0.0;
+
+    for (int workers : { 1, threads }) {
+      ThreadPool pool(workers);
+      for (const Case& cs : cases) {
+        const std::vector<double> thetas = randomThetas(cs.samples * dof, 53u + unsigned(dof + cs.samples));
+        auto diff = [](const Results& a, const Results& b) {
+          if (a.size() != b.size()) return 1.0;
+          double e = 0.0;
+          for (size_t i = 0; i < a.size(); ++i)
+            for (int c = 0; c < 12; ++c) e = std::max(e, std::fabs((&a[i].x)[c] - (&b[i].x)[c]));
+          return e;
+        };
+
+        Results ref, got;
+        chain.computeBatch(thetas.data(), cs.samples, ref);
+        Bulk::forwardKinematics(pool, chain, thetas.data(), cs.samples, got, Core::BatchOutput::AllFrames, cs.grain);
+        fkErr = std::max(fkErr, diff(ref, got));
+
+        chain.computeBatch(thetas.data(), cs.samples, ref, Core::BatchOutput::TcpOnly);
+        Bulk::forwardKinematics(pool, chain, thetas.data(), cs.samples, got, Core::BatchOutput::TcpOnly, cs.grain);
+        tcpErr = std::max(tcpErr, diff(ref, got));
+
+        std::vector<double> Jref, Jgot;
+        Results tcpRef, tcpGot;
+        engine.computeBatch(thetas.data(), cs.samples, Jref, &tcpRef);
+        Bulk::jacobians(pool, engine, thetas.data(), cs.samples, Jgot, &tcpGot, cs.grain);
+        if (Jref.size() != Jgot.size()) jacErr = 1.0;
+        else for (size_t r = 0; r < Jref.size(); ++r) jacErr = std::max(jacErr, std::fabs(Jref[r] - Jgot[r]));
+        jacErr = std::max(jacErr, diff(tcpRef, tcpGot));
+      }
+    }
+    run.check("bulk.fk", dof, fkErr, 0.0);
+    run.check("bulk.fk.tcp", dof, tcpErr, 0.0);
+    run.check("bulk.jacobian", dof, jacErr, 0.0);
+  }
+}
+
+// ---- IK: случайные углы -> поза FK -> решение из возмущённых стартов -> ошибка позы ----
+// С пределами — окно ±kWindow вокруг исходных углов (решение заведомо в пределах).
+// solveMultiSeed — с warm start и несколькими потоками; неверные пределы должны отвергаться.
+void checkIk(Bench::Runner& run) {
+  constexpr size_t kPoses = 12;
+  constexpr double kJitter = 10.0, kWindow = 60.0;   // градусы
+  const size_t dofs[] = { 6, 7, 12 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    const IkSolver solver(chain);
+    const CompiledChain fk(chain);
+    const std::vector<double> thetas = randomThetas(kPoses * dof, 53u + unsigned(dof));
+    const std::vector<double> jitter = randomThetas(kPoses * dof, 59u + unsigned(dof));
+
+    double free = 0.0, limited = 0.0, multi = 0.0, outside = 0.0;
+    std::vector<double> seed(dof);
+    for (size_t i = 0; i < kPoses; ++i) {
+      const double* t0 = thetas.data() + i * dof;
+      const Interp target = fk.computeTcp(t0);
+      for (size_t k = 0; k < dof; ++k) seed[k] = t0[k] + jitter[i * dof + k] / 180.0 * kJitter;
+
+      // Ошибка позы решения; не сошлось или отказ — бесконечность
+      auto poseErr = [&](const IkResult& r) {
+        if (!r.converged || !r.error.empty()) return HUGE_VAL;
+        const Interp p = fk.computeTcp(r.theta_deg.data());
+        double e = std::max({ std::fabs(p.x - target.x), std::fabs(p.y - target.y), std::fabs(p.z - target.z) });
+        for (int c = 3; c < 12; ++c) e = std::max(e, std::fabs((&p.x)[c] - (&target.x)[c]));
+        return e;
+      };
+
+      // Малое демпфирование и запас итераций: часть случайных поз близка к особым,
+      // там DLS сходится линейно
+      IkOptions opt;
+      opt.damping = 0.01;
+      opt.maxIterations = 1000;
+      opt.posTolerance = opt.rotTolerance = 1e-10;
+      free = std::max(free, poseErr(solver.solve(target, seed.data(), opt)));
+
+      opt.lowerDeg.resize(dof);
+      opt.upperDeg.resize(dof);
+      for (size_t k = 0; k < dof; ++k) {
+        opt.lowerDeg[k] = t0[k] - kWindow;
+        opt.upperDeg[k] = t0[k] + kWindow;
+      }
+      const IkResult r = solver.solve(target, seed.data(), opt);
+      limited = std::max(limited, poseErr(r));
+      for (size_t k = 0; k < dof && !r.theta_deg.empty(); ++k)
+        outside += (r.theta_deg[k] < opt.lowerDeg[k] || r.theta_deg[k] > opt.upperDeg[k]);
+
+      opt.seeds = 8;
+      opt.threads = 4;
+      opt.mode = (i % 2) ? IkOptions::Mode::Best : IkOptions::Mode::First;
+      multi = std::max(multi, poseErr(solver.solveMultiSeed(target, opt, seed.data())));
+    }
+    run.check("ik.roundtrip", dof, free, 1e-9);
+    run.check("ik.limits", dof, limited, 1e-9);
+    run.check("ik.limits.outside", dof, outside, 0.0);
+    run.check("ik.multiseed", dof, multi, 1e-9);
+
+    // Неверные параметры: lower > upper, NaN, длина не dof, damping 0 (в т.ч. без ориентации —
+    // вырожденная система), отрицательный и NaN — отказ с ошибкой, без решения
+    double accepted = 0.0;
+    std::vector<double> th(dof, 0.0);
+    const Interp target = fk.computeTcp(th.data());
+    for (int variant = 0; variant < 7; ++variant) {
+      IkOptions bad;
+      bad.lowerDeg.assign(dof, -90.0);
+      bad.upperDeg.assign(dof, 90.0);
+      if (variant == 0) bad.lowerDeg[dof / 2] = 100.0;
+      if (variant == 1) bad.upperDeg[0] = std::nan("");
+      if (variant == 2) bad.upperDeg.pop_back();
+      if (variant == 3) bad.damping = 0.0;
+      if (variant == 4) { bad.damping = 0.0; bad.orientationWeight = 0.0; }
+      if (variant == 5) bad.damping = -0.05;
+      if (variant == 6) bad.damping = std::nan("");
+      bad.threads = 2;
+      accepted += solver.solve(target, th.data(), bad).error.empty();
+      accepted += solver.solveMultiSeed(target, bad).error.empty();
+    }
+    run.check("ik.badoptions", dof, accepted, 0.0);
+  }
+}
+
+// ---- Воспроизведение: кадр TrajectoryPlayer против CompiledChain на тех же (интерполированных) углах ----
+void checkPlayback(Bench::Runner& run) {
+  constexpr size_t kSamples = 64;
+  const size_t dofs[] = { 1, 6, 24 };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 23u + unsigned(dof));
+    const CompiledChain ref(chain);
+
+    TrajectoryPlayer player;
+    player.load(chain, thetas.data(), kSamples, 100.0);
+
+    Results out, expect;
+    std::vector<double> theta(dof);
+    double exact = 0.0, interp = 0.0;
+    for (size_t k = 0; k + 1 < kSamples; k += 7) {
+      for (int half = 0; half < 2; ++half) {
+        const double pos = double(k) + 0.5 * half;
+        player.seek(pos);
+        // Кадр считается в фоне: ждём, пока tick() отдаст именно эту позицию
+        while (!(player.tick(out) && player.shownPosition() == pos)) std::this_thread::yield();
+
+        const double* a = thetas.data() + k * dof;
+        const double* b = a + dof;
+        for (size_t j = 0; j < dof; ++j) theta[j] = half ? a[j] + (b[j] - a[j]) * 0.5 : a[j];
+        ref.compute(theta.data(), expect);
+
+        double err = 0.0;
+        for (size_t i = 0; i < dof; ++i) {
+          for (int c = 0; c < 12; ++c) err = std::max(err, std::fabs((&out[i].x)[c] - (&expect[i].x)[c]));
+        }
+        double& worst = half ? interp : exact;
+        worst = std::max(worst, err);
+      }
+    }
+    run.check("playback.frame", dof, exact, 0.0);
+    run.check("playback.interp", dof, interp, 0.0);
+
+    // По кругу: перемотка на последнюю выборку (и дальше — обрезается) показывает последнюю,
+    // а не первую; на полвыборки раньше — середину последнего отрезка
+    player.setLoop(true);
+    double loopErr = 0.0;
+    const double last = double(kSamples - 1);
+    const double seeks[] = { last, last - 0.5, last + 5.0 };
+    const double shown[] = { last, last - 0.5, last };
+    for (int s = 0; s < 3; ++s) {
+      player.seek(seeks[s]);
+      while (!(player.tick(out) && player.shownPosition() == player.position())) std::this_thread::yield();
+      loopErr = std::max(loopErr, std::fabs(player.shownPosition() - shown[s]));
+
+      const double* b = thetas.data() + (kSamples - 1) * dof;
+      const double* a = b - dof;
+      for (size_t j = 0; j < dof; ++j) theta[j] = (s == 1) ? a[j] + (b[j] - a[j]) * 0.5 : b[j];
+      ref.compute(theta.data(), expect);
+      for (size_t i = 0; i < dof; ++i) loopErr = std::max(loopErr, frameError(out[i], expect[i]));
+    }
+    run.check("playback.loop.end", dof, loopErr, 0.0);
+  }
+}
+
+// ---- Файл траектории: запись -> чтение без потерь, испорченные заголовки отвергаются ----
+std::vector<unsigned char> readFile(const std::string& path) {
+  std::vector<unsigned char> bytes;
+  if (std::FILE* f = std::fopen(path.c_str(), "rb")) {
+    unsigned char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) bytes.insert(bytes.end(), buf, buf + n);
+    std::fclose(f);
+  }
+  return bytes;
+}
+
+void writeFile(const std::string& path, const std::vector<unsigned char>& bytes, size_t size) {
+  if (std::FILE* f = std::fopen(path.c_str(), "wb")) {
+    std::fwrite(bytes.data(), 1, size, f);
+    std::fclose(f);
+  }
+}
+
+void checkTrajectoryFile(Bench::Runner& run) {
+  constexpr size_t kSamples = 257;
+  const size_t dofs[] = { 1, 6, 24 };
+  const std::string dir = std::filesystem::temp_directory_path().string();
+  const std::string path = dir + "/robotdh_bench_check.rdht";
+  const std::string bad = dir + "/robotdh_bench_check_bad.rdht";
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 29u + unsigned(dof));
+    Trajectory::Reader reader;
+    double err = 0.0;
+    auto chainErr = [&] {
+      if (reader.chain().size() != dof) return 1.0;
+      double e = 0.0;
+      for (size_t j = 0; j < dof; ++j) {
+        e = std::max({ e, std::fabs(reader.chain()[j].theta_deg - chain[j].theta_deg),
+                       std::fabs(reader.chain()[j].a_m - chain[j].a_m),
+                       std::fabs(reader.chain()[j].d_m - chain[j].d_m),
+                       std::fabs(reader.chain()[j].alpha_rad - chain[j].alpha_rad) });
+      }
+      return e;
+    };
+
+    // Углы
+    if (!Trajectory::writeThetas(path, chain, thetas.data(), kSamples) || !reader.open(path) ||
+        reader.kind() != Trajectory::Kind::Thetas || reader.samples() != kSamples) {
+      err = 1.0;
+    } else {
+      err = std::max(err, chainErr());
+      for (size_t j = 0; j < dof; ++j) {
+        const double* col = reader.thetaColumn(j);
+        for (size_t i = 0; i < kSamples; ++i) err = std::max(err, std::fabs(col[i] - thetas[i * dof + j]));
+      }
+    }
+    run.check("trajectory.thetas", dof, err, 0.0);
+
+    // Кадры FK (все) и позы (только TCP)
+    Results frames;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), kSamples, frames);
+    err = 0.0;
+    if (!Trajectory::writeResults(path, chain, frames, kSamples, Core::BatchOutput::AllFrames) ||
+        !reader.open(path) || reader.kind() != Trajectory::Kind::Results || reader.framesPerSample() != dof) {
+      err = 1.0;
+    } else {
+      err = std::max(err, chainErr());
+      for (size_t i = 0; i < kSamples; ++i) {
+        for (size_t f = 0; f < dof; ++f) {
+          const Interp got = reader.frame(i, f);
+          for (int k = 0; k < 12; ++k) err = std::max(err, std::fabs((&got.x)[k] - (&frames[i * dof + f].x)[k]));
+        }
+      }
+    }
+    run.check("trajectory.results", dof, err, 0.0);
+
+    Poses poses;
+    CompiledChain(chain).computeBatchPoses(thetas.data(), kSamples, poses, Core::BatchOutput::TcpOnly);
+    err = 0.0;
+    if (!Trajectory::writePoses(path, chain, poses, kSamples, Core::BatchOutput::TcpOnly) ||
+        !reader.open(path) || reader.kind() != Trajectory::Kind::Poses || reader.framesPerSample() != 1) {
+      err = 1.0;
+    } else {
+      for (size_t i = 0; i < kSamples; ++i) {
+        const Pose got = reader.pose(i, 0);
+        for (int k = 0; k < 7; ++k) err = std::max(err, std::fabs((&got.x)[k] - (&poses[i].x)[k]));
+      }
+    }
+    run.check("trajectory.poses", dof, err, 0.0);
+  }
+
+  // Испорченные файлы: каждый должен быть отвергнут (max_error — число принятых)
+  const Snapshot chain = makeChain(6);
+  const std::vector<double> thetas = randomThetas(kSamples * 6, 31u);
+  Trajectory::writeThetas(path, chain, thetas.data(), kSamples);
+  const std::vector<unsigned char> good = readFile(path);
+  auto patch = [&](size_t offset, uint64_t value, size_t width) {
+    std::vector<unsigned char> b = good;
+    if (width == 4) { const uint32_t v = uint32_t(value); std::memcpy(b.data() + offset, &v, 4); }
+    else            { std::memcpy(b.data() + offset, &value, 8); }
+    return b;
+  };
+  const struct { std::vector<unsigned char> bytes; size_t size; } cases[] = {
+    { good, good.size() - sizeof(double) },                                         // обрезан хвост данных
+    { good, sizeof(Trajectory::Header) - 1 },                                       // обрезан заголовок
+    { patch(offsetof(Trajectory::Header, dataOffset), uint64_t(1) << 63, 8), good.size() },
+    { patch(offsetof(Trajectory::Header, dataOffset), (good.size() + 64) & ~uint64_t(63), 8), good.size() },
+    { patch(offsetof(Trajectory::Header, chainOffset), 0, 8), good.size() },
+    { patch(offsetof(Trajectory::Header, chainOffset), ~uint64_t(0) - 8, 8), good.size() },
+    { patch(offsetof(Trajectory::Header, samples), ~uint64_t(0) / 8, 8), good.size() },
+    { patch(offsetof(Trajectory::Header, dof), 0x7fffffff, 4), good.size() },
+    { patch(offsetof(Trajectory::Header, version), Trajectory::kVersion + 1, 4), good.size() },
+    { patch(0, 0, 8), good.size() },                                                // magic
+  };
+  double accepted = 0.0;
+  for (const auto& cs : cases) {
+    writeFile(bad, cs.bytes, cs.size);
+    Trajectory::Reader reader;
+    if (reader.open(bad)) accepted += 1.0;
+  }
+  run.check("trajectory.corrupt", 6, accepted, 0.0);
+
+  std::remove(path.c_str());
+  std::remove(bad.c_str());
+}
+
+// ---- robotdh_cli: CSV через три стадии процесса против CompiledChain ----
+// Кусок --block 7 не делит число выборок, потоков расчёта 1 и несколько: номера выборок
+// должны идти подряд, значения — как у computeTcp / compute (до %.10g в выходе), а выход
+// при любом числе потоков — побайтно тот же. Ошибки разбора — код 1, нет файла цепи — 2.
+// Память (только POSIX): пик RSS robotdh_cli на входе в десятки МБ — единицы МБ. Меряет свежий
+// robotdh_bench --child-rss: fork копирует RSS родителя, и в пик попал бы образ этого процесса.
+#if defined(_WIN32)
+constexpr const char* kNullDevice = "NUL";
+#else
+constexpr const char* kNullDevice = "/dev/null";
+#endif
+
+int runCommand(const std::string& cmd) {
+  const int rc = std::system(cmd.c_str());
+#if defined(_WIN32)
+  return rc;
+#else
+  return (rc != -1 && WIFEXITED(rc)) ? WEXITSTATUS(rc) : -1;
+#endif
+}
+
+std::string readText(const std::string& path) {
+  std::string s;
+  if (std::FILE* f = std::fopen(path.c_str(), "rb")) {
+    char buf[1 << 14];
+    size_t got;
+    while ((got = std::fread(buf, 1, sizeof(buf), f)) > 0) s.append(buf, got);
+    std::fclose(f);
+  }
+  return s;
+}
+
+#if !defined(_WIN32)
+// --child-rss FILE: выполнить команду из FILE, напечатать "пик_RSS_дочерних_КБ код_возврата"
+int peakChildRss(const std::string& cmdFile) {
+  const int rc = runCommand(readText(cmdFile));
+  struct rusage ru{};
+  getrusage(RUSAGE_CHILDREN, &ru);
+#if defined(__APPLE__)
+  const long kb = long(ru.ru_maxrss / 1024);   // ru_maxrss в байтах
+#else
+  const long kb = long(ru.ru_maxrss);          // в КБ
+#endif
+  std::printf("%ld %d\n", kb, rc);
+  return 0;
+}
+#endif
+
+void checkCli(Bench::Runner& run, const std::string& cli, const std::string& self) {
+  if (!std::filesystem::exists(cli)) {
+    std::fprintf(stderr, "robotdh_bench: %s not found (--cli)\n", cli.c_str());
+    run.check("cli.found", 0, 1.0, 0.0);
+    return;
+  }
+  constexpr size_t kSamples = 1003;
+  constexpr size_t kDof = 6;
+  const std::string dir = std::filesystem::temp_directory_path().string();
+  const std::string chainPath = dir + "/robotdh_bench_cli_chain.csv";
+  const std::string inPath = dir + "/robotdh_bench_cli_in.csv";
+  const std::string outPath = dir + "/robotdh_bench_cli_out.csv";
+  const std::string badPath = dir + "/robotdh_bench_cli_bad.csv";
+  const std::string quoted = "\"" + cli + "\"";
+  auto command = [&](const std::string& input, const std::string& output, const std::string& extra) {
+    return quoted + " --chain \"" + chainPath + "\" --input \"" + input + "\" --output \"" + output
+         + "\" " + extra + " 2>" + kNullDevice;
+  };
+
+  const Snapshot chain = makeChain(kDof);
+  double reach = 0.0;
+  for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+  if (std::FILE* f = std::fopen(chainPath.c_str(), "wb")) {
+    std::fprintf(f, "theta_deg,a_m,d_m,alpha_rad\n");
+    for (const JointDH& j : chain) std::fprintf(f, "%.17g,%.17g,%.17g,%.17g\n", j.theta_deg, j.a_m, j.d_m, j.alpha_rad);
+    std::fclose(f);
+  }
+
+  // Вход: заголовок, комментарий, пустые строки, все разделители, CRLF
+  const std::vector<double> thetas = randomThetas(kSamples * kDof, 61u);
+  if (std::FILE* f = std::fopen(inPath.c_str(), "wb")) {
+    std::fprintf(f, "j1,j2,j3,j4,j5,j6\n# comment\n\n");
+    const char seps[] = { ',', ';', ' ', '\t' };
+    for (size_t i = 0; i < kSamples; ++i) {
+      for (size_t j = 0; j < kDof; ++j) {
+        if (j) std::fputc(seps[(i + j) % 4], f);
+        std::fprintf(f, "%.17g", thetas[i * kDof + j]);
+      }
+      std::fputs((i % 5 == 0) ? "\r\n" : "\n", f);
+    }
+    std::fclose(f);
+  }
+
+  const CompiledChain fk(chain);
+  const int threads = int(std::max(4u, std::thread::hardware_concurrency()));
+  double valueErr = 0.0, order = 0.0, parse = 0.0;
+  Results frames;
+
+  for (bool all : { false, true }) {
+    std::string first;
+    for (int t : { 1, threads }) {
+      const std::string extra = "--block 7 --threads " + std::to_string(t) + (all ? " --frames all" : "");
+      if (runCommand(command(inPath, outPath, extra)) != 0) { order += 1.0; continue; }
+      const std::string text = readText(outPath);
+      if (t == 1) first = text;
+      else if (text != first) order += 1.0;
+
+      // Разбор выхода: заголовок, затем sample[,joint],12 значений по строке
+      const char* p = text.c_str();
+      const char* nl = std::strchr(p, '\n');
+      if (!nl) { order += 1.0; continue; }
+      p = nl + 1;
+      const size_t rows = all ? kSamples * kDof : kSamples;
+      size_t row = 0;
+      for (; *p && row < rows; ++row) {
+        const size_t i = all ? row / kDof : row;
+        const size_t j = all ? row % kDof : kDof - 1;
+        char* end = nullptr;
+        if (std::strtoull(p, &end, 10) != i) order += 1.0;
+        p = end + 1;
+        if (all) {
+          if (std::strtoull(p, &end, 10) != j) order += 1.0;
+          p = end + 1;
+        }
+        fk.compute(thetas.data() + i * kDof, frames);
+        for (int c = 0; c < 12; ++c) {
+          const double v = std::strtod(p, &end);
+          valueErr = std::max(valueErr, std::fabs(v - (&frames[j].x)[c]));
+          p = end + 1;
+        }
+        if (end[0] != '\n') order += 1.0;
+      }
+      if (row != rows || *p) order += 1.0;
+    }
+  }
+  run.check("cli.values", kDof, valueErr, 1e-9 * std::max(1.0, reach));
+  run.check("cli.order", kDof, order, 0.0);
+
+  // Ошибки: мусор посреди потока, неполная строка, лишнее значение — код 1; нет цепи — 2
+  const char* badInputs[] = { "1,2,3,4,5,6\nabc,2,3,4,5,6\n", "1,2,3,4,5,6\n1,2,3\n", "1,2,3,4,5,6,7\n" };
+  for (const char* bad : badInputs) {
+    if (std::FILE* f = std::fopen(badPath.c_str(), "wb")) { std::fputs(bad, f); std::fclose(f); }
+    parse += runCommand(command(badPath, outPath, "--threads 2")) != 1;
+  }
+  parse += runCommand(quoted + " --chain \"" + dir + "/robotdh_bench_cli_missing.csv\" --input \"" + inPath
+                      + "\" --output " + kNullDevice + " 2>" + kNullDevice) != 2;
+  // Только заголовок — пустой, но успешный выход
+  if (std::FILE* f = std::fopen(badPath.c_str(), "wb")) { std::fputs("j1,j2,j3,j4,j5,j6\n", f); std::fclose(f); }
+  parse += runCommand(command(badPath, outPath, "")) != 0;
+  const std::string headerOnly = readText(outPath);
+  parse += std::count(headerOnly.begin(), headerOnly.end(), '\n') != 1;
+  run.check("cli.parse", kDof, parse, 0.0);
+
+#if !defined(_WIN32)
+  // Пик RSS на крупном входе (~45 МБ): стадии держат по паре блоков --block, поэтому пик —
+  // единицы МБ при любой длине входа (граница с запасом на сам процесс и стеки потоков)
+  constexpr size_t kLarge = 600000;
+  long long inputBytes = 0;
+  if (std::FILE* f = std::fopen(inPath.c_str(), "wb")) {
+    for (size_t i = 0; i < kLarge; ++i) {
+      const double* th = thetas.data() + (i % kSamples) * kDof;
+      inputBytes += std::fprintf(f, "%.9f,%.9f,%.9f,%.9f,%.9f,%.9f\n", th[0], th[1], th[2], th[3], th[4], th[5]);
+    }
+    std::fclose(f);
+  }
+  if (std::FILE* f = std::fopen(badPath.c_str(), "wb")) {
+    std::fputs(command(inPath, kNullDevice, "--block 1024 --threads 2").c_str(), f);
+    std::fclose(f);
+  }
+  long peakKb = 0;
+  int rc = -1;
+  if (runCommand("\"" + self + "\" --child-rss \"" + badPath + "\" > \"" + outPath + "\"") != 0
+      || std::sscanf(readText(outPath).c_str(), "%ld %d", &peakKb, &rc) != 2)
+    rc = -1;
+  const double peakMb = double(peakKb) / 1024.0;
+  std::fprintf(stderr, "cli.memory: input %.1f MB, peak RSS %.1f MB\n", double(inputBytes) / (1 << 20), peakMb);
+  run.check("cli.memory", kDof, rc == 0 ? peakMb : 1e9, 16.0);
+#endif
+
+  std::remove(chainPath.c_str());
+  std::remove(inPath.c_str());
+  std::remove(outPath.c_str());
+  std::remove(badPath.c_str());
+}
+
+// ---- Точность: полиномиальный sincos в FkSimd против Core (допуск — FkSimd::trigTolerance) ----
+void checkTrig(Bench::Runner& run) {
+  constexpr size_t kSamples = 4000;
+  const size_t dofs[] = { 1, 6, 24, 64 };
+  const struct { const char* name; FastTrig::Accuracy trig; } levels[] = {
+    { "trig.libm",     FastTrig::Accuracy::Libm },
+    { "trig.polyfull", FastTrig::Accuracy::PolyFull },
+    { "trig.poly1e9",  FastTrig::Accuracy::Poly1e9 },
+    { "trig.poly1e6",  FastTrig::Accuracy::Poly1e6 },
+  };
+
+  for (size_t dof : dofs) {
+    const Snapshot chain = makeChain(dof);
+    double reach = 0.0;
+    for (const JointDH& j : chain) reach += std::fabs(j.a_m) + std::fabs(j.d_m);
+
+    const std::vector<double> thetas = randomThetas(kSamples * dof, 11u + unsigned(dof));
+    Results ref;
+    Core::computeForwardKinematicsBatch(chain, thetas.data(), kSamples, ref);
+
+    for (const auto& lv : levels) {
+      for (int isa = 0; isa <= static_cast<int>(FkSimd::detectIsa()); ++isa) {
+        Results r;
+        FkSimd::computeBatch(chain, thetas.data(), kSamples, r, Core::BatchOutput::AllFrames,
+                             static_cast<FkSimd::Isa>(isa), lv.trig);
+        double err = 0.0;
+        for (size_t i = 0; i < r.size(); ++i) {
+          const double* p = &r[i].x;
+          const double* q = &ref[i].x;
+          for (int c = 0; c < 12; ++c) err = std::max(err, std::fabs(p[c] - q[c]));
+        }
+        run.check(std::string(lv.name) + "." + FkSimd::isaName(static_cast<FkSimd::Isa>(isa)),
+                  dof, err, FkSimd::trigTolerance(lv.trig, dof, reach));
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) { usage(); return 2; }
+#if !defined(_WIN32)
+  if (!opt.childRssFile.empty()) return peakChildRss(opt.childRssFile);
+#endif
+
+  std::FILE* out = (opt.outputPath == "-") ? stdout : std::fopen(opt.outputPath.c_str(), "wb");
+  if (!out) { std::fprintf(stderr, "robotdh_bench: cannot open %s\n", opt.outputPath.c_str()); return 2; }
+
+  Bench::Runner run(opt.bench);
+  if (opt.check) {
+    checkFloat(run);
+    checkTrig(run);
+    checkQuaternion(run);
+    checkFixedChain(run);
+    checkIncremental(run);
+    checkAllocs(run);
+    checkCompiled(run);
+    checkPose(run);
+    checkSoa(run);
+    checkCollision(run);
+    checkVoxelGrid(run);
+    checkWorkspace(run);
+    checkJacobian(run);
+    checkBulk(run);
+    checkIk(run);
+    checkPlayback(run);
+    checkTrajectoryFile(run);
+    if (opt.cliPath.empty()) {
+      std::filesystem::path p = std::filesystem::path(argv[0]).parent_path() / "robotdh_cli";
+#if defined(_WIN32)
+      p += ".exe";
+#endif
+      opt.cliPath = p.string();
+    }
+    checkCli(run, opt.cliPath, argv[0]);
+    run.writeJson(out, FkSimd::isaName(FkSimd::detectIsa()));
+    if (out != stdout) std::fclose(out);
+    return run.allChecksPassed() ? 0 : 1;
+  }
+
+  benchCoreMath(run);
+  for (size_t dof : opt.dofs) benchDof(run, dof);
+
+#if defined(ROBOTDH_BENCH_GUI)
+  runGuiBenchmarks(run, argc, argv, opt.dofs);
+#endif
+
+  run.writeJson(out, FkSimd::isaName(FkSimd::detectIsa()));
+  if (out != stdout) std::fclose(out);
+  return 0;
+}
@@ -0,0 +1,368 @@
+// robotdh_cli — прямая кинематика без GUI для длинных журналов суставов.
+//
+//   robotdh_cli [--chain FILE | --preset tz6] [--input FILE|-] [--output FILE|-]
+//               [--frames tcp|all] [--block N] [--threads N] [--collision [--radius R]]
+//
+// Цепь (--chain): CSV "theta_deg,a_m,d_m,alpha_rad" по строке на звено (как таблица в GUI);
+//   для расчёта берутся a, d, alpha, theta задаёт поток. По умолчанию — пресет из ТЗ.
+// Поток (--input, по умолчанию stdin): по строке на конфигурацию, dof углов theta в градусах,
+//   разделители — запятая, точка с запятой, пробел или таб. Пустые строки, строки с '#'
+//   и нечисловой заголовок пропускаются.
+// Выход (--output, по умолчанию stdout): CSV
+//   tcp: sample,x,y,z,xx,xy,xz,yx,yy,yz,zx,zy,zz
+//   all: sample,joint,x,y,z,...
+// --collision — самопересечение по капсулам звеньев (collision.h), к каждой строке добавляются
+//   clearance,body_a,body_b: наименьший зазор выборки (< 0 — звенья пересекаются) и пара тел
+//   (-1 — проверять нечего). --radius — радиус капсул в метрах; по умолчанию — как в 3D-виде.
+//
+// Память ограничена: чтение, расчёт и запись идут тремя стадиями через очереди
+// фиксированной глубины по --block конфигураций, поэтому длина входа роли не играет,
+// а ввод-вывод перекрывается с расчётом.
+
+#include "compiled_chain.h"
+#include "bulk_eval.h"
+#include "collision.h"
+#include "presets.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// ---- Очередь фиксированной глубины между стадиями ----
+template <class T>
+class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : cap_(capacity) {}
+
+  // false — очередь закрыта с другой стороны
+  bool push(T v) {
+    std::unique_lock<std::mutex> lock(m_);
+    notFull_.wait(lock, [&] { return q_.size() < cap_ || closed_; });
+    if (closed_) return false;
+    q_.push_back(std::move(v));
+    notEmpty_.notify_one();
+    return true;
+  }
+
+  // false — очередь пуста и закрыта
+  bool pop(T& v) {
+    std::unique_lock<std::mutex> lock(m_);
+    notEmpty_.wait(lock, [&] { return !q_.empty() || closed_; });
+    if (q_.empty()) return false;
+    v = std::move(q_.front());
+    q_.pop_front();
+    notFull_.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(m_);
+    closed_ = true;
+    notEmpty_.notify_all();
+    notFull_.notify_all();
+  }
+
+private:
+  size_t cap_;
+  bool closed_ = false;
+  std::deque<T> q_;
+  std::mutex m_;
+  std::condition_variable notEmpty_, notFull_;
+};
+
+// ---- Построчное чтение через большой буфер (fread), без std::string на строку ----
+class LineReader {
+public:
+  explicit LineReader(std::FILE* f, size_t bufSize = 1 << 20) : f_(f), buf_(bufSize + 1) {}
+
+  // Следующая строка [b, e); *e — '\n' или '\0', так что strtod не выйдет за строку
+  bool next(const char*& b, const char*& e) {
+    for (;;) {
+      const char* nl = static_cast<const char*>(std::memchr(buf_.data() + pos_, '\n', end_ - pos_));
+      if (nl) {
+        b = buf_.data() + pos_;
+        e = nl;
+        pos_ = static_cast<size_t>(nl - buf_.data()) + 1;
+        return true;
+      }
+      if (eof_) {
+        if (pos_ >= end_) return false;
+        b = buf_.data() + pos_;          // последняя строка без '\n'
+        e = buf_.data() + end_;
+        pos_ = end_;
+        return true;
+      }
+      refill();
+    }
+  }
+
+private:
+  void refill() {
+    // Недочитанный хвост — в начало буфера; если строка длиннее буфера — растим
+    const size_t tail = end_ - pos_;
+    std::memmove(buf_.data(), buf_.data() + pos_, tail);
+    pos_ = 0;
+    end_ = tail;
+    if (end_ + 1 >= buf_.size()) buf_.resize(buf_.size() * 2);
+
+    const size_t got = std::fread(buf_.data() + end_, 1, buf_.size() - 1 - end_, f_);
+    end_ += got;
+    buf_[end_] = '\0';
+    if (got == 0) eof_ = true;
+  }
+
+  std::FILE* f_;
+  std::vector<char> buf_;
+  size_t pos_ = 0, end_ = 0;
+  bool eof_ = false;
+};
+
+// Разобрать до max чисел из [b, e) в out; вернуть сколько прочитано (или -1 при мусоре)
+int parseNumbers(const char* b, const char* e, double* out, int max) {
+  int n = 0;
+  const char* p = b;
+  while (p < e) {
+    while (p < e && (*p == ',' || *p == ';' || *p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    if (p >= e) break;
+    char* stop = nullptr;
+    const double v = std::strtod(p, &stop);
+    if (stop == p) return -1;
+    if (n < max) out[n] = v;
+    ++n;
+    p = stop;
+  }
+  return n;
+}
+
+bool isSkippable(const char* b, const char* e) {
+  while (b < e && (*b == ' ' || *b == '\t' || *b == '\r')) ++b;
+  return b == e || *b == '#';
+}
+
+struct Options {
+  std::string chainPath;
+  std::string inputPath  = "-";
+  std::string outputPath = "-";
+  bool   allFrames = false;
+  size_t block     = 8192;
+  int    threads   = 1;
+  bool   collision = false;
+  double radius    = 0.0;
+};
+
+void usage() {
+  std::fprintf(stderr,
+    "usage: robotdh_cli [--chain FILE | --preset tz6] [--input FILE|-] [--output FILE|-]\n"
+    "                   [--frames tcp|all] [--block N] [--threads N] [--collision [--radius R]]\n");
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    auto value = [&](std::string& dst) {
+      if (i + 1 >= argc) return false;
+      dst = argv[++i];
+      return true;
+    };
+    std::string v;
+    if      (a == "--chain")  { if (!value(o.chainPath)) return false; }
+    else if (a == "--preset") { if (!value(v) || v != "tz6") return false; o.chainPath.clear(); }
+    else if (a == "--input")  { if (!value(o.inputPath)) return false; }
+    else if (a == "--output") { if (!value(o.outputPath)) return false; }
+    else if (a == "--frames") {
+      if (!value(v) || (v != "tcp" && v != "all")) return false;
+      o.allFrames = (v == "all");
+    }
+    else if (a == "--block")   { if (!value(v)) return false; o.block = std::max<size_t>(1, std::strtoull(v.c_str(), nullptr, 10)); }
+    else if (a == "--threads") { if (!value(v)) return false; o.threads = std::atoi(v.c_str()); }
+    else if (a == "--collision") { o.collision = true; }
+    else if (a == "--radius")  { if (!value(v)) return false; o.radius = std::strtod(v.c_str(), nullptr); }
+    else return false;
+  }
+  return true;
+}
+
+bool loadChain(const std::string& path, Snapshot& chain) {
+  if (path.empty()) {
+    chain = Presets::Default();
+    return true;
+  }
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) {
+    std::fprintf(stderr, "robotdh_cli: cannot open chain file %s\n", path.c_str());
+    return false;
+  }
+  LineReader rd(f, 1 << 12);
+  const char *b, *e;
+  size_t line = 0;
+  chain.clear();
+  while (rd.next(b, e)) {
+    ++line;
+    if (isSkippable(b, e)) continue;
+    double v[4];
+    const int n = parseNumbers(b, e, v, 4);
+    if (n < 0 && chain.empty()) continue;          // заголовок
+    if (n != 4) {
+      std::fprintf(stderr, "robotdh_cli: %s:%zu: expected theta,a,d,alpha\n", path.c_str(), line);
+      std::fclose(f);
+      return false;
+    }
+    chain.push_back(JointDH{ v[0], v[1], v[2], v[3] });
+  }
+  std::fclose(f);
+  if (chain.empty()) {
+    std::fprintf(stderr, "robotdh_cli: chain file %s is empty\n", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Блок конфигураций: углы N x dof и номер первой выборки
+struct InBlock {
+  size_t first = 0;
+  size_t count = 0;
+  std::vector<double> thetas;
+};
+
+void appendFrame(std::string& s, size_t sample, long joint, const Interp& f,
+                 const Collision::Result* col) {
+  char tmp[400];
+  int n;
+  if (joint < 0) {
+    n = std::snprintf(tmp, sizeof(tmp),
+                      "%zu,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g",
+                      sample, f.x, f.y, f.z, f.xx, f.xy, f.xz, f.yx, f.yy, f.yz, f.zx, f.zy, f.zz);
+  } else {
+    n = std::snprintf(tmp, sizeof(tmp),
+                      "%zu,%ld,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g",
+                      sample, joint, f.x, f.y, f.z, f.xx, f.xy, f.xz, f.yx, f.yy, f.yz, f.zx, f.zy, f.zz);
+  }
+  if (n <= 0) return;
+  n = std::min<int>(n, sizeof(tmp) - 1);
+  if (col) {
+    const int m = std::snprintf(tmp + n, sizeof(tmp) - size_t(n), ",%.10g,%d,%d",
+                                col->distance, col->bodyA, col->bodyB);
+    if (m > 0) n = std::min<int>(n + m, sizeof(tmp) - 1);
+  }
+  s.append(tmp, static_cast<size_t>(n));
+  s.push_back('\n');
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) { usage(); return 2; }
+
+  Snapshot chainSnap;
+  if (!loadChain(opt.chainPath, chainSnap)) return 2;
+  const CompiledChain chain(chainSnap);
+  const size_t dof = chain.dof();
+
+  std::FILE* in = (opt.inputPath == "-") ? stdin : std::fopen(opt.inputPath.c_str(), "rb");
+  if (!in) { std::fprintf(stderr, "robotdh_cli: cannot open %s\n", opt.inputPath.c_str()); return 2; }
+  std::FILE* out = (opt.outputPath == "-") ? stdout : std::fopen(opt.outputPath.c_str(), "wb");
+  if (!out) { std::fprintf(stderr, "robotdh_cli: cannot open %s\n", opt.outputPath.c_str()); return 2; }
+
+  // Глубина 2 на каждой стадии: одна порция в работе, одна готовится
+  BoundedQueue<InBlock> toCompute(2);
+  BoundedQueue<std::string> toWrite(2);
+  bool parseError = false;
+
+  // ---- Стадия 1: чтение и разбор ----
+  std::thread reader([&] {
+    LineReader rd(in);
+    const char *b, *e;
+    size_t line = 0;
+    bool headerAllowed = true;
+    InBlock blk;
+    blk.thetas.resize(opt.block * dof);
+
+    while (rd.next(b, e)) {
+      ++line;
+      if (isSkippable(b, e)) continue;
+      const int n = parseNumbers(b, e, blk.thetas.data() + blk.count * dof, static_cast<int>(dof));
+      if (n < 0 && headerAllowed) { headerAllowed = false; continue; }
+      headerAllowed = false;
+      if (n != static_cast<int>(dof)) {
+        std::fprintf(stderr, "robotdh_cli: input line %zu: expected %zu joint values\n", line, dof);
+        parseError = true;
+        break;
+      }
+      if (++blk.count == opt.block) {
+        const size_t next = blk.first + blk.count;
+        if (!toCompute.push(std::move(blk))) break;
+        blk = InBlock{};
+        blk.first = next;
+        blk.thetas.resize(opt.block * dof);
+      }
+    }
+    if (blk.count > 0 && !parseError) toCompute.push(std::move(blk));
+    toCompute.close();
+  });
+
+  // ---- Стадия 3: запись ----
+  std::thread writer([&] {
+    std::string chunk;
+    while (toWrite.pop(chunk)) std::fwrite(chunk.data(), 1, chunk.size(), out);
+    std::fflush(out);
+  });
+
+  // ---- Стадия 2: расчёт и форматирование (в этом потоке) ----
+  std::unique_ptr<ThreadPool> pool;
+  if (opt.threads != 1) pool = std::make_unique<ThreadPool>(opt.threads);
+
+  // Капсулам нужны все кадры, даже если в выход идёт только TCP
+  const bool allFrames = opt.allFrames || opt.collision;
+  const Core::BatchOutput mode = allFrames ? Core::BatchOutput::AllFrames : Core::BatchOutput::TcpOnly;
+  Collision::Options colOpt;
+  colOpt.radius = opt.radius;
+  Results frames;
+  std::vector<Collision::Result> clearance;
+  InBlock blk;
+  {
+    std::string header = opt.allFrames ? "sample,joint," : "sample,";
+    header += "x,y,z,xx,xy,xz,yx,yy,yz,zx,zy,zz";
+    header += opt.collision ? ",clearance,body_a,body_b\n" : "\n";
+    toWrite.push(std::move(header));
+  }
+  while (toCompute.pop(blk)) {
+    if (pool) Bulk::forwardKinematics(*pool, chain, blk.thetas.data(), blk.count, frames, mode);
+    else      chain.computeBatch(blk.thetas.data(), blk.count, frames, mode);
+    if (opt.collision) Collision::checkBatch(pool.get(), frames.data(), blk.count, dof, colOpt, clearance);
+
+    std::string text;
+    text.reserve(frames.size() * 160);
+    for (size_t i = 0; i < blk.count; ++i) {
+      const Collision::Result* col = opt.collision ? &clearance[i] : nullptr;
+      if (opt.allFrames) {
+        for (size_t j = 0; j < dof; ++j)
+          appendFrame(text, blk.first + i, static_cast<long>(j), frames[i * dof + j], col);
+      } else {
+        appendFrame(text, blk.first + i, -1, allFrames ? frames[i * dof + dof - 1] : frames[i], col);
+      }
+    }
+    toWrite.push(std::move(text));
+  }
+  toWrite.close();
+
+  reader.join();
+  writer.join();
+
+  if (in != stdin) std::fclose(in);
+  const bool writeError = std::ferror(out) != 0;
+  if (out != stdout) std::fclose(out);
+
+  if (writeError) { std::fprintf(stderr, "robotdh_cli: write error\n"); return 1; }
+  return parseError ? 1 : 0;
+}
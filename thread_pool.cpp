@@ -0,0 +1,107 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int workers) {
+  if (workers <= 0) workers = static_cast<int>(std::thread::hardware_concurrency());
+  const int threads = std::max(1, workers) - 1;   // вызывающий поток — тоже исполнитель
+
+  // Очереди: по одной на фоновый поток + одна для вызывающего
+  for (int i = 0; i <= threads; ++i) queues_.push_back(std::make_unique<Queue>());
+
+  threads_.reserve(static_cast<size_t>(threads));
+  for (int i = 0; i < threads; ++i) threads_.emplace_back([this, i] { workerMain(i); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wakeM_);
+    stop_ = true;
+  }
+  wakeCv_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const Body& body) {
+  if (count == 0) return;
+  grain = std::max<size_t>(1, grain);
+
+  std::lock_guard<std::mutex> job(jobM_);
+
+  const size_t tasks = (count + grain - 1) / grain;
+  const size_t n = queues_.size();
+
+  // Тело и счётчик — до раздачи кусков: кто взял кусок, тот видит актуальное тело
+  body_ = &body;
+  pending_.store(tasks);
+
+  // Каждому исполнителю — сплошной отрезок кусков (локальность), остальное докрадут
+  for (size_t w = 0; w < n; ++w) {
+    const size_t first = tasks * w / n;
+    const size_t last  = tasks * (w + 1) / n;
+    std::lock_guard<std::mutex> lock(queues_[w]->m);
+    for (size_t t = first; t < last; ++t)
+      queues_[w]->q.push_back(Task{ t * grain, std::min(count, (t + 1) * grain) });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(wakeM_);
+    ++generation_;
+  }
+  wakeCv_.notify_all();
+
+  // Вызывающий поток — последний слот
+  drain(static_cast<int>(n) - 1);
+
+  std::unique_lock<std::mutex> lock(doneM_);
+  doneCv_.wait(lock, [this] { return pending_.load() == 0; });
+  body_ = nullptr;
+}
+
+void ThreadPool::workerMain(int id) {
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(wakeM_);
+      wakeCv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+    drain(id);
+  }
+}
+
+void ThreadPool::drain(int id) {
+  Task t;
+  while (pending_.load() > 0) {
+    if (!popLocal(id, t) && !steal(id, t)) break;   // всё роздано, остаток доделывают другие
+
+    (*body_)(t.begin, t.end, id);
+
+    if (pending_.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(doneM_);
+      doneCv_.notify_all();
+    }
+  }
+}
+
+bool ThreadPool::popLocal(int id, Task& t) {
+  Queue& q = *queues_[static_cast<size_t>(id)];
+  std::lock_guard<std::mutex> lock(q.m);
+  if (q.q.empty()) return false;
+  t = q.q.back();
+  q.q.pop_back();
+  return true;
+}
+
+bool ThreadPool::steal(int id, Task& t) {
+  const size_t n = queues_.size();
+  for (size_t k = 1; k < n; ++k) {
+    Queue& q = *queues_[(static_cast<size_t>(id) + k) % n];
+    std::lock_guard<std::mutex> lock(q.m);
+    if (q.q.empty()) continue;
+    t = q.q.front();
+    q.q.pop_front();
+    return true;
+  }
+  return false;
+}
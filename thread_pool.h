@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с кражей работы для пакетных расчётов (FK/якобианы по траекториям).
+// У каждого исполнителя своя очередь кусков: свои берутся с конца, чужие крадутся с начала.
+// Диапазон [0, count) режется на куски по grain элементов независимо от числа потоков,
+// поэтому при записи результатов по индексу порядок выхода детерминирован.
+//
+// Тело цикла получает номер исполнителя worker в [0, slots()) — по нему удобно держать
+// per-thread буферы (scratch[worker]). Вызывающий поток тоже работает (последний слот).
+// Тело не должно бросать исключений; одновременно выполняется один parallelFor.
+class ThreadPool {
+public:
+  using Body = std::function<void(size_t begin, size_t end, int worker)>;
+
+  // workers — всего исполнителей, включая вызывающий поток; 0 — по числу ядер
+  explicit ThreadPool(int workers = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Сколько исполнителей (фоновые + вызывающий) — размер массива per-thread буферов
+  int slots() const { return static_cast<int>(queues_.size()); }
+
+  // Выполнить body над [0, count) кусками по grain; возвращается, когда всё готово
+  void parallelFor(size_t count, size_t grain, const Body& body);
+
+private:
+  struct Task { size_t begin, end; };
+  struct Queue {
+    std::mutex m;
+    std::deque<Task> q;
+  };
+
+  void workerMain(int id);
+  void drain(int id);                  // работать, пока есть куски
+  bool popLocal(int id, Task& t);      // своя очередь, с конца
+  bool steal(int id, Task& t);         // чужие очереди, с начала
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> threads_;
+
+  const Body* body_ = nullptr;
+  std::atomic<size_t> pending_{0};     // куски текущего задания, ещё не выполненные
+
+  std::mutex jobM_;                    // один parallelFor за раз
+  std::mutex wakeM_;
+  std::condition_variable wakeCv_;
+  uint64_t generation_ = 0;            // растёт с каждым заданием
+  bool stop_ = false;
+
+  std::mutex doneM_;
+  std::condition_variable doneCv_;
+};
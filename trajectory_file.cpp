@@ -0,0 +1,291 @@
+#include "trajectory_file.h"
+#include "fk_simd.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Trajectory {
+
+namespace {
+constexpr char kMagic[8] = { 'R', 'D', 'H', 'T', 'R', 'A', 'J', '1' };
+constexpr uint64_t kAlign = 64;
+
+bool fail(std::string* error, const std::string& msg) {
+  if (error) *error = msg;
+  return false;
+}
+
+Header makeHeader(Kind kind, uint32_t dof, uint32_t framesPerSample, uint64_t samples) {
+  Header h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.byteOrder = kByteOrderTag;
+  h.kind = static_cast<uint32_t>(kind);
+  h.dof = dof;
+  h.framesPerSample = framesPerSample;
+  h.samples = samples;
+  h.chainOffset = sizeof(Header);
+  const uint64_t chainEnd = h.chainOffset + uint64_t(dof) * 4 * sizeof(double);
+  h.dataOffset = (chainEnd + kAlign - 1) / kAlign * kAlign;
+  return h;
+}
+
+// Заголовок + цепь + выравнивание до данных
+bool writePrologue(std::FILE* f, const Header& h, const Snapshot& chain) {
+  if (std::fwrite(&h, sizeof(h), 1, f) != 1) return false;
+  for (const auto& j : chain) {
+    const double v[4] = { j.theta_deg, j.a_m, j.d_m, j.alpha_rad };
+    if (std::fwrite(v, sizeof(v), 1, f) != 1) return false;
+  }
+  const uint64_t written = h.chainOffset + uint64_t(chain.size()) * sizeof(double) * 4;
+  static const char zeros[kAlign] = {};
+  return std::fwrite(zeros, 1, size_t(h.dataOffset - written), f) == size_t(h.dataOffset - written);
+}
+
+// Столбец по сборщику get(i): через буфер, чтобы не делать fwrite на каждое число
+template <class Get>
+bool writeColumn(std::FILE* f, uint64_t samples, Get get) {
+  double buf[4096];
+  size_t n = 0;
+  for (uint64_t i = 0; i < samples; ++i) {
+    buf[n++] = get(i);
+    if (n == sizeof(buf) / sizeof(buf[0])) {
+      if (std::fwrite(buf, sizeof(double), n, f) != n) return false;
+      n = 0;
+    }
+  }
+  return n == 0 || std::fwrite(buf, sizeof(double), n, f) == n;
+}
+
+// Полей на кадр по виду данных
+int fieldsPerFrame(uint32_t kind) {
+  return kind == uint32_t(Kind::Poses) ? kPoseFields : kInterpFields;
+}
+
+bool finish(std::FILE* f, bool ok, const std::string& path, std::string* error) {
+  ok = (std::fclose(f) == 0) && ok;
+  return ok ? true : fail(error, "write error: " + path);
+}
+} // namespace
+
+// ---- Запись ----
+
+bool writeThetas(const std::string& path, const Snapshot& chain,
+                 const double* thetas_deg, uint64_t samples, std::string* error) {
+  const size_t dof = chain.size();
+  if (dof == 0) return fail(error, "empty chain");
+  if (samples > 0 && !thetas_deg) return fail(error, "no data");
+
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return fail(error, "cannot open " + path);
+
+  const Header h = makeHeader(Kind::Thetas, uint32_t(dof), 0, samples);
+  bool ok = writePrologue(f, h, chain);
+  for (size_t j = 0; ok && j < dof; ++j)
+    ok = writeColumn(f, samples, [&](uint64_t i) { return thetas_deg[i * dof + j]; });
+  return finish(f, ok, path, error);
+}
+
+bool writeResults(const std::string& path, const Snapshot& chain,
+                  const Results& frames, uint64_t samples, Core::BatchOutput mode,
+                  std::string* error) {
+  const size_t dof = chain.size();
+  if (dof == 0) return fail(error, "empty chain");
+  const size_t perSample = (mode == Core::BatchOutput::TcpOnly) ? 1 : dof;
+  if (frames.size() != samples * perSample) return fail(error, "frames/samples mismatch");
+
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return fail(error, "cannot open " + path);
+
+  const Header h = makeHeader(Kind::Results, uint32_t(dof), uint32_t(perSample), samples);
+  bool ok = writePrologue(f, h, chain);
+  for (size_t fr = 0; ok && fr < perSample; ++fr) {
+    for (int c = 0; ok && c < kInterpFields; ++c) {
+      ok = writeColumn(f, samples, [&](uint64_t i) {
+        return (&frames[size_t(i) * perSample + fr].x)[c];
+      });
+    }
+  }
+  return finish(f, ok, path, error);
+}
+
+bool writePoses(const std::string& path, const Snapshot& chain,
+                const Poses& poses, uint64_t samples, Core::BatchOutput mode,
+                std::string* error) {
+  const size_t dof = chain.size();
+  if (dof == 0) return fail(error, "empty chain");
+  const size_t perSample = (mode == Core::BatchOutput::TcpOnly) ? 1 : dof;
+  if (poses.size() != samples * perSample) return fail(error, "poses/samples mismatch");
+
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return fail(error, "cannot open " + path);
+
+  const Header h = makeHeader(Kind::Poses, uint32_t(dof), uint32_t(perSample), samples);
+  bool ok = writePrologue(f, h, chain);
+  for (size_t fr = 0; ok && fr < perSample; ++fr) {
+    for (int c = 0; ok && c < kPoseFields; ++c) {
+      ok = writeColumn(f, samples, [&](uint64_t i) {
+        return (&poses[size_t(i) * perSample + fr].x)[c];
+      });
+    }
+  }
+  return finish(f, ok, path, error);
+}
+
+// ---- Чтение ----
+
+bool Reader::open(const std::string& path, std::string* error) {
+  close();
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return fail(error, "cannot open " + path);
+  LARGE_INTEGER sz;
+  if (!GetFileSizeEx(file, &sz) || sz.QuadPart < LONGLONG(sizeof(Header))) {
+    CloseHandle(file);
+    return fail(error, "not a trajectory file: " + path);
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!view) {
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    return fail(error, "cannot map " + path);
+  }
+  file_ = file;
+  mapping_ = mapping;
+  size_ = uint64_t(sz.QuadPart);
+  data_ = static_cast<const unsigned char*>(view);
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return fail(error, "cannot open " + path);
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(Header))) {
+    ::close(fd);
+    return fail(error, "not a trajectory file: " + path);
+  }
+  void* view = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  if (view == MAP_FAILED) {
+    ::close(fd);
+    return fail(error, "cannot map " + path);
+  }
+  ::madvise(view, size_t(st.st_size), MADV_SEQUENTIAL);
+  fd_ = fd;
+  size_ = uint64_t(st.st_size);
+  data_ = static_cast<const unsigned char*>(view);
+#endif
+
+  // ---- Проверка заголовка ----
+  std::memcpy(&header_, data_, sizeof(Header));
+  const Header& h = header_;
+  std::string why;
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) why = "bad magic";
+  else if (h.byteOrder != kByteOrderTag)                 why = "foreign byte order";
+  else if (h.version != kVersion)                        why = "unsupported version";
+  else if (h.kind > uint32_t(Kind::Poses))               why = "unknown data kind";
+  else if (h.dof == 0)                                   why = "empty chain";
+  else if (h.kind != uint32_t(Kind::Thetas) && h.framesPerSample != 1 && h.framesPerSample != h.dof)
+                                                         why = "bad frames per sample";
+  // Смещения из файла не складываются: сумма может переполниться и пройти проверку
+  else if (h.dataOffset % kAlign != 0 || h.dataOffset > size_ ||
+           h.chainOffset < sizeof(Header) || h.chainOffset > h.dataOffset ||
+           uint64_t(h.dof) * 4 * sizeof(double) > h.dataOffset - h.chainOffset)
+                                                         why = "bad offsets";
+  else {
+    const uint64_t columns = (h.kind == uint32_t(Kind::Thetas))
+        ? h.dof : uint64_t(h.framesPerSample) * uint64_t(fieldsPerFrame(h.kind));
+    if (h.samples > (size_ - h.dataOffset) / sizeof(double) / columns)
+      why = "truncated data";
+  }
+  if (!why.empty()) {
+    close();
+    return fail(error, why + ": " + path);
+  }
+
+  chain_.resize(h.dof);
+  for (size_t j = 0; j < h.dof; ++j) {
+    double v[4];
+    std::memcpy(v, data_ + h.chainOffset + j * sizeof(v), sizeof(v));
+    chain_[j] = JointDH{ v[0], v[1], v[2], v[3] };
+  }
+  return true;
+}
+
+void Reader::close() {
+#if defined(_WIN32)
+  if (data_) UnmapViewOfFile(data_);
+  if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+  if (file_) CloseHandle(static_cast<HANDLE>(file_));
+  mapping_ = nullptr;
+  file_ = nullptr;
+#else
+  if (data_) ::munmap(const_cast<unsigned char*>(data_), size_t(size_));
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  header_ = Header{};
+  chain_.clear();
+}
+
+const double* Reader::thetaColumn(size_t joint) const {
+  if (!data_ || kind() != Kind::Thetas || joint >= dof()) return nullptr;
+  return column(joint);
+}
+
+const double* Reader::resultColumn(size_t frame, int field) const {
+  if (!data_ || kind() != Kind::Results || frame >= framesPerSample() ||
+      field < 0 || field >= kInterpFields) return nullptr;
+  return column(frame * kInterpFields + size_t(field));
+}
+
+Interp Reader::frame(uint64_t sample, size_t frameIndex) const {
+  Interp out{};
+  if (!data_ || kind() != Kind::Results || sample >= samples() || frameIndex >= framesPerSample())
+    return out;
+  double* dst = &out.x;
+  for (int c = 0; c < kInterpFields; ++c) dst[c] = column(frameIndex * kInterpFields + size_t(c))[sample];
+  return out;
+}
+
+const double* Reader::poseColumn(size_t frame, int field) const {
+  if (!data_ || kind() != Kind::Poses || frame >= framesPerSample() ||
+      field < 0 || field >= kPoseFields) return nullptr;
+  return column(frame * kPoseFields + size_t(field));
+}
+
+Pose Reader::pose(uint64_t sample, size_t frameIndex) const {
+  Pose out{};
+  if (!data_ || kind() != Kind::Poses || sample >= samples() || frameIndex >= framesPerSample())
+    return out;
+  double* dst = &out.x;
+  for (int c = 0; c < kPoseFields; ++c) dst[c] = column(frameIndex * kPoseFields + size_t(c))[sample];
+  return out;
+}
+
+void Reader::computeForwardKinematics(uint64_t first, size_t count, Results& out,
+                                      Core::BatchOutput mode) const {
+  out.clear();
+  if (!data_ || kind() != Kind::Thetas || first >= samples()) return;
+  count = size_t(std::min<uint64_t>(count, samples() - first));
+
+  // Столбцовая раскладка: соседние выборки подряд, суставы через samples
+  FkSimd::computeBatchStrided(chain_, column(0) + first, count, 1, size_t(samples()), out, mode);
+}
+
+} // namespace Trajectory
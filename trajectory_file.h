@@ -0,0 +1,114 @@
+#pragma once
+#include "core.h"
+#include "pose.h"
+#include <cstdint>
+#include <string>
+
+// Бинарный столбцовый формат траектории (*.rdht).
+//
+//   [Header, 72 байта]  magic "RDHTRAJ1", версия, метка порядка байт, вид данных,
+//                       dof, кадров на выборку, число выборок, смещения цепи и данных
+//   [цепь]              dof x JointDH (theta_deg, a_m, d_m, alpha_rad) — 4 double на звено
+//   [данные]            с границы 64 байт, по столбцам, каждый столбец — samples double:
+//                         Thetas:  dof столбцов, столбец j — theta сустава j (градусы)
+//                         Results: framesPerSample * 12 столбцов, столбец f*12 + c —
+//                                  компонента c (порядок полей Interp: x,y,z,xx..zz) кадра f
+//                         Poses:   framesPerSample * 7 столбцов, столбец f*7 + c —
+//                                  компонента c (порядок полей Pose: x,y,z,qw,qx,qy,qz) кадра f
+//
+// Чтение — через отображение файла в память (mmap / MapViewOfFile): столбцы отдаются
+// указателями прямо в отображение и уходят в пакетную FK (FkSimd) без копирования и разбора.
+// Порядок байт — как у машины-писателя; читатель с другим порядком файл отвергает.
+namespace Trajectory {
+
+enum class Kind : uint32_t { Thetas = 0, Results = 1, Poses = 2 };
+
+struct Header {
+  char     magic[8];          // "RDHTRAJ1"
+  uint32_t version;           // kVersion
+  uint32_t byteOrder;         // kByteOrderTag в порядке байт писателя
+  uint32_t kind;              // Kind
+  uint32_t dof;
+  uint32_t framesPerSample;   // Results/Poses: 1 (только TCP) или dof; Thetas: 0
+  uint32_t reserved0;
+  uint64_t samples;
+  uint64_t chainOffset;       // байт от начала файла
+  uint64_t dataOffset;        // байт от начала файла, кратно 64
+  uint64_t reserved[2];
+};
+static_assert(sizeof(Header) == 72, "Trajectory::Header: раскладка не должна меняться");
+
+constexpr uint32_t kVersion      = 1;
+constexpr uint32_t kByteOrderTag = 0x01020304u;
+constexpr int      kInterpFields = 12;
+constexpr int      kPoseFields   = 7;
+
+// ---- Запись ----
+// Углы: thetas_deg — N x dof построчно (как у пакетной FK), в файл уходят по столбцам
+bool writeThetas(const std::string& path, const Snapshot& chain,
+                 const double* thetas_deg, uint64_t samples, std::string* error = nullptr);
+
+// Результаты FK: frames — раскладка пакетной FK (AllFrames: N*dof, TcpOnly: N)
+bool writeResults(const std::string& path, const Snapshot& chain,
+                  const Results& frames, uint64_t samples, Core::BatchOutput mode,
+                  std::string* error = nullptr);
+
+// Позы (pose.h): 7 столбцов на кадр вместо 12 — почти вдвое меньше файла
+bool writePoses(const std::string& path, const Snapshot& chain,
+                const Poses& poses, uint64_t samples, Core::BatchOutput mode,
+                std::string* error = nullptr);
+
+// ---- Чтение (отображение в память) ----
+class Reader {
+public:
+  Reader() = default;
+  ~Reader() { close(); }
+  Reader(const Reader&) = delete;
+  Reader& operator=(const Reader&) = delete;
+
+  bool open(const std::string& path, std::string* error = nullptr);
+  void close();
+  bool isOpen() const { return data_ != nullptr; }
+
+  Kind kind() const { return static_cast<Kind>(header_.kind); }
+  size_t dof() const { return header_.dof; }
+  uint64_t samples() const { return header_.samples; }
+  size_t framesPerSample() const { return header_.framesPerSample; }
+  const Snapshot& chain() const { return chain_; }
+
+  // Thetas: столбец сустава joint (samples значений), указатель в отображение
+  const double* thetaColumn(size_t joint) const;
+
+  // Results: столбец компоненты field (0..11, порядок Interp) кадра frame
+  const double* resultColumn(size_t frame, int field) const;
+
+  // Results: собрать один кадр
+  Interp frame(uint64_t sample, size_t frame) const;
+
+  // Poses: столбец компоненты field (0..6, порядок Pose) кадра frame; собрать одну позу
+  const double* poseColumn(size_t frame, int field) const;
+  Pose pose(uint64_t sample, size_t frame) const;
+
+  // Thetas: FK по выборкам [first, first + count) прямо из отображения (FkSimd, без копии углов)
+  void computeForwardKinematics(uint64_t first, size_t count, Results& out,
+                                Core::BatchOutput mode = Core::BatchOutput::TcpOnly) const;
+
+private:
+  const double* column(size_t index) const {
+    return reinterpret_cast<const double*>(data_ + header_.dataOffset) + index * header_.samples;
+  }
+
+  const unsigned char* data_ = nullptr;
+  uint64_t size_ = 0;
+  Header header_{};
+  Snapshot chain_;
+
+#if defined(_WIN32)
+  void* file_ = nullptr;      // HANDLE
+  void* mapping_ = nullptr;   // HANDLE
+#else
+  int fd_ = -1;
+#endif
+};
+
+} // namespace Trajectory
@@ -0,0 +1,200 @@
+#include "trajectory_player.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+bool fail(std::string* error, const std::string& msg) {
+  if (error) *error = msg;
+  return false;
+}
+} // namespace
+
+bool TrajectoryPlayer::load(const Snapshot& chain, const double* thetas_deg, size_t samples,
+                            double sampleRate, std::string* error) {
+  const size_t dof = chain.size();
+  if (dof == 0) return fail(error, "empty chain");
+  if (samples == 0 || !thetas_deg) return fail(error, "no samples");
+  if (!(sampleRate > 0.0)) return fail(error, "sample rate must be positive");
+
+  stopWorker();
+  chain_.compile(chain);
+  thetas_.assign(thetas_deg, thetas_deg + samples * dof);
+  samples_ = samples;
+  sampleRate_ = sampleRate;
+
+  playing_ = false;
+  anchor_ = 0.0;
+  anchorTime_ = Clock::now();
+  lastRequested_ = -1.0;
+  shownPosition_ = -1.0;
+  hasRequest_ = hasReady_ = false;
+  ready_.clear();
+  stats_ = Stats{};
+  startWorker();
+  return true;
+}
+
+bool TrajectoryPlayer::load(const Trajectory::Reader& reader, double sampleRate, std::string* error) {
+  if (!reader.isOpen()) return fail(error, "trajectory is not open");
+  if (reader.kind() != Trajectory::Kind::Thetas) return fail(error, "trajectory has no joint angles");
+
+  const size_t dof = reader.dof();
+  const size_t samples = size_t(reader.samples());
+  std::vector<double> rows(samples * dof);
+  for (size_t j = 0; j < dof; ++j) {
+    const double* col = reader.thetaColumn(j);
+    for (size_t i = 0; i < samples; ++i) rows[i * dof + j] = col[i];
+  }
+  return load(reader.chain(), rows.data(), samples, sampleRate, error);
+}
+
+void TrajectoryPlayer::unload() {
+  stopWorker();
+  thetas_.clear();
+  samples_ = 0;
+  playing_ = false;
+  lastRequested_ = shownPosition_ = -1.0;
+}
+
+// ---- Часы ----
+
+double TrajectoryPlayer::wrap(double sample) const {
+  const double last = double(samples_ > 0 ? samples_ - 1 : 0);
+  if (loop_ && last > 0.0) {
+    sample = std::fmod(sample, last);
+    return sample < 0.0 ? sample + last : sample;
+  }
+  return std::min(std::max(sample, 0.0), last);
+}
+
+double TrajectoryPlayer::position() const {
+  if (!playing_) return anchor_;
+  const double elapsed = std::chrono::duration<double>(Clock::now() - anchorTime_).count();
+  return wrap(anchor_ + elapsed * speed_ * sampleRate_);
+}
+
+void TrajectoryPlayer::play() {
+  if (!loaded() || playing_) return;
+  if (!loop_ && anchor_ >= double(samples_ - 1)) anchor_ = 0.0;
+  anchorTime_ = Clock::now();
+  playing_ = true;
+}
+
+void TrajectoryPlayer::pause() {
+  if (!playing_) return;
+  anchor_ = position();
+  playing_ = false;
+}
+
+void TrajectoryPlayer::seek(double sample) {
+  if (!loaded()) return;
+  // Обрезка и при loop: wrap свернул бы последнюю выборку (ровно период) в первую
+  anchor_ = std::min(std::max(sample, 0.0), double(samples_ - 1));
+  anchorTime_ = Clock::now();
+}
+
+void TrajectoryPlayer::setSpeed(double speed) {
+  if (!(speed > 0.0)) return;
+  // Перепривязка к текущей позиции, чтобы смена скорости не давала скачка
+  anchor_ = position();
+  anchorTime_ = Clock::now();
+  speed_ = speed;
+}
+
+// ---- Кадр GUI ----
+
+bool TrajectoryPlayer::tick(Results& out) {
+  if (!loaded()) return false;
+
+  double pos = position();
+  if (playing_ && !loop_ && pos >= double(samples_ - 1)) {
+    // Дошли до конца: встать на последней выборке
+    anchor_ = pos = double(samples_ - 1);
+    playing_ = false;
+  }
+  if (pos != lastRequested_) request(pos);
+
+  std::lock_guard<std::mutex> lk(m_);
+  if (!hasReady_) return false;
+  out.swap(ready_);
+  hasReady_ = false;
+  shownPosition_ = readyPos_;
+  ++stats_.delivered;
+  return true;
+}
+
+TrajectoryPlayer::Stats TrajectoryPlayer::stats() const {
+  std::lock_guard<std::mutex> lk(m_);
+  return stats_;
+}
+
+void TrajectoryPlayer::request(double sample) {
+  lastRequested_ = sample;
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    if (hasRequest_) ++stats_.superseded;   // фоновый поток не успел взять прежний заказ
+    hasRequest_ = true;
+    requestPos_ = sample;
+    requestMode_ = interp_;
+    ++stats_.requested;
+  }
+  cv_.notify_one();
+}
+
+void TrajectoryPlayer::thetasAt(double sample, Interpolation mode, double* theta_deg) const {
+  const size_t dof = chain_.dof();
+  const double s = std::min(std::max(sample, 0.0), double(samples_ - 1));
+  if (mode == Interpolation::Nearest) {
+    const double* row = thetas_.data() + size_t(std::lround(s)) * dof;
+    std::copy(row, row + dof, theta_deg);
+    return;
+  }
+  const size_t i0 = size_t(s);
+  const size_t i1 = std::min(i0 + 1, samples_ - 1);
+  const double f = s - double(i0);
+  const double* a = thetas_.data() + i0 * dof;
+  const double* b = thetas_.data() + i1 * dof;
+  for (size_t j = 0; j < dof; ++j) theta_deg[j] = a[j] + (b[j] - a[j]) * f;
+}
+
+// ---- Фоновый поток ----
+
+void TrajectoryPlayer::startWorker() {
+  stop_ = false;
+  worker_ = std::thread([this] { workerMain(); });
+}
+
+void TrajectoryPlayer::stopWorker() {
+  if (!worker_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  worker_.join();
+}
+
+void TrajectoryPlayer::workerMain() {
+  std::vector<double> theta(chain_.dof());
+  Results buf;   // задний буфер; готовый — ready_
+
+  std::unique_lock<std::mutex> lk(m_);
+  for (;;) {
+    cv_.wait(lk, [this] { return stop_ || hasRequest_; });
+    if (stop_) return;
+    const double pos = requestPos_;
+    const Interpolation mode = requestMode_;
+    hasRequest_ = false;
+    lk.unlock();
+
+    thetasAt(pos, mode, theta.data());
+    chain_.compute(theta.data(), buf);
+
+    lk.lock();
+    if (hasReady_) ++stats_.superseded;     // GUI не забрал прежний кадр
+    ready_.swap(buf);                       // прежний готовый кадр (или буфер GUI) — новый задний
+    hasReady_ = true;
+    readyPos_ = pos;
+    ++stats_.computed;
+  }
+}
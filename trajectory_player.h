@@ -0,0 +1,124 @@
+#pragma once
+#include "compiled_chain.h"
+#include "core.h"
+#include "trajectory_file.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Воспроизведение траектории суставов в реальном времени (без Qt, для 3D-вида и сервисов).
+//
+// Позиция — дробный номер выборки и идёт по steady_clock:
+//   position = anchor + elapsed * speed * sampleRate.
+// Потоку GUI остаётся tick() на каждый кадр: пересчитать позицию, заказать FK фоновому потоку
+// и забрать последний готовый кадр. Расчёта tick() не ждёт — мьютекс держится на время swap.
+// FK (CompiledChain, все кадры) считается в задний буфер фонового потока, готовый кадр меняется
+// с ним местами; буферы ходят по кругу (задний -> готовый -> вызывающего -> готовый -> задний),
+// выделений памяти в установившемся режиме нет.
+//
+// Бюджет кадра держится сам: заказ — всегда на текущую позицию часов, новый заказ заменяет
+// невзятый (выборки между кадрами пропускаются, см. Stats::superseded), а между выборками
+// углы интерполируются линейно — при замедлении или частоте кадров выше частоты выборок
+// движение остаётся плавным. На паузе без перемотки tick() ничего не заказывает.
+class TrajectoryPlayer {
+public:
+  enum class Interpolation { Nearest, Linear };
+
+  struct Stats {
+    uint64_t requested = 0;    // заказов FK
+    uint64_t computed = 0;     // посчитанных кадров
+    uint64_t superseded = 0;   // заказов и готовых кадров, заменённых более свежими
+    uint64_t delivered = 0;    // кадров, отданных tick()
+  };
+
+  TrajectoryPlayer() = default;
+  ~TrajectoryPlayer() { stopWorker(); }
+  TrajectoryPlayer(const TrajectoryPlayer&) = delete;
+  TrajectoryPlayer& operator=(const TrajectoryPlayer&) = delete;
+
+  // Траектория: thetas_deg — samples x dof построчно (копируется), sampleRate — выборок в секунду
+  bool load(const Snapshot& chain, const double* thetas_deg, size_t samples, double sampleRate,
+            std::string* error = nullptr);
+  // Файл *.rdht вида Thetas: столбцы переписываются построчно, reader после загрузки не нужен
+  bool load(const Trajectory::Reader& reader, double sampleRate, std::string* error = nullptr);
+  void unload();
+
+  bool loaded() const { return samples_ > 0; }
+  size_t dof() const { return chain_.dof(); }
+  size_t samples() const { return samples_; }
+  double sampleRate() const { return sampleRate_; }
+  double duration() const { return samples_ > 1 ? double(samples_ - 1) / sampleRate_ : 0.0; }   // секунды
+
+  // ---- Управление (поток GUI) ----
+  void play();                          // с конца (без loop) — с начала
+  void pause();
+  bool playing() const { return playing_; }
+  void seek(double sample);             // перемотка, обрезается до [0, samples-1]
+  void setSpeed(double speed);          // множитель времени, > 0
+  double speed() const { return speed_; }
+  void setLoop(bool loop) { loop_ = loop; }
+  bool loop() const { return loop_; }
+  void setInterpolation(Interpolation mode) { interp_ = mode; lastRequested_ = -1.0; }
+  Interpolation interpolation() const { return interp_; }
+
+  // Текущая позиция по часам (дробная выборка)
+  double position() const;
+
+  // Кадр GUI: true — в out новый кадр (dof кадров, как Core::computeForwardKinematics),
+  // прежнее содержимое out уходит фоновому потоку как буфер
+  bool tick(Results& out);
+
+  // Позиция последнего кадра, отданного tick(); -1 — ещё не было
+  double shownPosition() const { return shownPosition_; }
+
+  // Заказанный кадр ещё не отдан (для остановки таймера на паузе)
+  bool pending() const { return lastRequested_ != shownPosition_; }
+
+  Stats stats() const;
+
+  // Углы в позиции sample с текущей интерполяцией; theta_deg — dof значений
+  void thetasAt(double sample, double* theta_deg) const { thetasAt(sample, interp_, theta_deg); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void thetasAt(double sample, Interpolation mode, double* theta_deg) const;
+  double wrap(double sample) const;     // loop — по кругу с периодом samples-1, иначе — обрезать
+  void request(double sample);
+  void startWorker();
+  void stopWorker();
+  void workerMain();
+
+  // Траектория: меняется только при остановленном фоновом потоке
+  CompiledChain chain_;
+  std::vector<double> thetas_;          // samples_ x dof построчно
+  size_t samples_ = 0;
+  double sampleRate_ = 0.0;
+
+  // Часы и управление (поток GUI)
+  bool playing_ = false;
+  bool loop_ = false;
+  double speed_ = 1.0;
+  Interpolation interp_ = Interpolation::Linear;
+  double anchor_ = 0.0;                 // позиция в anchorTime_
+  Clock::time_point anchorTime_;
+  double lastRequested_ = -1.0;
+  double shownPosition_ = -1.0;
+
+  // Обмен с фоновым потоком (под m_)
+  mutable std::mutex m_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  bool hasRequest_ = false;
+  double requestPos_ = 0.0;
+  Interpolation requestMode_ = Interpolation::Linear;
+  bool hasReady_ = false;
+  double readyPos_ = 0.0;
+  Results ready_;                       // последний готовый кадр (задний буфер — в workerMain)
+  Stats stats_;
+  std::thread worker_;
+};
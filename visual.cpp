@@ -26,7 +26,9 @@ void Visual::setupHeaders(QTableWidget* table, int rows) const {
 
   // Заголовки строк (Joint 1..N)
   QStringList rowNames;
-  Presets::MakeJointNames(static_cast<size_t>(rows), rowNames);
+  rowNames.reserve(rows);
+  for (int r = 0; r < rows; ++r)
+    rowNames << QString::fromStdString(Presets::JointName(static_cast<size_t>(r)));
   table->setVerticalHeaderLabels(rowNames);
 
   // Немного оформления
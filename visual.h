@@ -31,6 +31,10 @@ public:
   // Принять рассчитанные результаты и передать в рендер
   void setComputed(const Results& r) { results_ = r; if (renderer_) renderer_->setData(results_); }
 
+  // То же без копии: r и results_ меняются местами, в r возвращается прежний расчёт
+  // (воспроизведение: буфер уходит обратно в TrajectoryPlayer::tick)
+  void swapComputed(Results& r) { results_.swap(r); if (renderer_) renderer_->setData(results_); }
+
   // Очистить результаты (по желанию)
   void clearComputed() { results_.clear(); }
 
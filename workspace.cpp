@@ -0,0 +1,171 @@
+#include "workspace.h"
+#include "fk_simd.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// ---- VoxelGrid ----
+
+bool VoxelGrid::cellOf(double voxel, double x, double y, double z, int& ix, int& iy, int& iz) {
+  // Проверка до приведения к int: floor за пределами int — неопределённое поведение,
+  // а лишние старшие биты маска в pack молча срезала бы (чужой воксель)
+  constexpr double limit = double(1 << 20);
+  const double f[3] = { std::floor(x / voxel), std::floor(y / voxel), std::floor(z / voxel) };
+  for (double v : f)
+    if (!(v >= -limit && v < limit)) return false;   // NaN тоже сюда
+  ix = static_cast<int>(f[0]);
+  iy = static_cast<int>(f[1]);
+  iz = static_cast<int>(f[2]);
+  return true;
+}
+
+uint64_t VoxelGrid::pack(int ix, int iy, int iz) {
+  constexpr uint64_t mask = (1ULL << 21) - 1;
+  return  (static_cast<uint64_t>(ix) & mask)
+       | ((static_cast<uint64_t>(iy) & mask) << 21)
+       | ((static_cast<uint64_t>(iz) & mask) << 42);
+}
+
+void VoxelGrid::unpack(uint64_t key, int& ix, int& iy, int& iz) {
+  // Знаковое расширение 21-битного поля
+  auto field = [](uint64_t v) {
+    const int64_t x = static_cast<int64_t>(v & ((1ULL << 21) - 1));
+    return static_cast<int>((x ^ (1LL << 20)) - (1LL << 20));
+  };
+  ix = field(key);
+  iy = field(key >> 21);
+  iz = field(key >> 42);
+}
+
+bool VoxelGrid::add(double x, double y, double z) {
+  int ix, iy, iz;
+  if (!cellOf(voxel_, x, y, z, ix, iy, iz)) {
+    ++outside_;
+    return false;
+  }
+  ++cells_[pack(ix, iy, iz)];
+  ++total_;
+  return true;
+}
+
+void VoxelGrid::merge(const VoxelGrid& other) {
+  for (const auto& kv : other.cells_) cells_[kv.first] += kv.second;
+  total_ += other.total_;
+  outside_ += other.outside_;
+}
+
+uint32_t VoxelGrid::countAt(double x, double y, double z) const {
+  int ix, iy, iz;
+  if (!cellOf(voxel_, x, y, z, ix, iy, iz)) return 0u;
+  const auto it = cells_.find(pack(ix, iy, iz));
+  return it == cells_.end() ? 0u : it->second;
+}
+
+// ---- Сэмплер ----
+
+namespace {
+
+// Пределы: оба пусты или оба длины dof, конечные и lower <= upper (uniform_real_distribution
+// при lower > upper или бесконечной ширине — неопределённое поведение)
+bool checkOptions(const WorkspaceOptions& opt, size_t dof, std::string* error) {
+  if (!(opt.voxelSize > 0.0) || !std::isfinite(opt.voxelSize)) {
+    *error = "voxel size must be positive";
+    return false;
+  }
+  if (opt.lowerDeg.empty() && opt.upperDeg.empty()) return true;
+  if (opt.lowerDeg.size() != dof || opt.upperDeg.size() != dof) {
+    *error = "joint limits must have " + std::to_string(dof) + " entries";
+    return false;
+  }
+  for (size_t k = 0; k < dof; ++k) {
+    const double a = opt.lowerDeg[k], b = opt.upperDeg[k];
+    if (!(std::isfinite(a) && std::isfinite(b) && a <= b)) {
+      *error = "bad limits for joint " + std::to_string(k);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+WorkspaceResult sampleWorkspace(const Snapshot& chain, const WorkspaceOptions& opt) {
+  const auto t0 = std::chrono::steady_clock::now();
+
+  WorkspaceResult res;
+  res.grid = VoxelGrid(opt.voxelSize);
+  const size_t dof = chain.size();
+  if (!checkOptions(opt, dof, &res.error)) return res;
+  if (dof == 0 || opt.samples == 0) return res;
+
+  const bool limits = !opt.lowerDeg.empty();
+  const size_t chunk = std::max<size_t>(1, opt.chunk);
+  const uint64_t chunks = (opt.samples + chunk - 1) / chunk;
+
+  ThreadPool pool(opt.threads);
+  const size_t slots = static_cast<size_t>(pool.slots());
+
+  // Всё своё у исполнителя: сетка, буфер углов, буфер TCP, габарит
+  struct Scratch {
+    VoxelGrid grid;
+    std::vector<double> thetas;
+    ResultsSoA tcp;   // только позиции TCP: 3 столбца, оси не считаются
+    double lo[3], hi[3];
+  };
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  std::vector<Scratch> scratch(slots);
+  for (auto& sc : scratch) {
+    sc.grid = VoxelGrid(opt.voxelSize);
+    sc.thetas.resize(chunk * dof);
+    sc.lo[0] = sc.lo[1] = sc.lo[2] = inf;
+    sc.hi[0] = sc.hi[1] = sc.hi[2] = -inf;
+  }
+
+  // Один кусок пула = один пакет FK из chunk конфигураций
+  pool.parallelFor(static_cast<size_t>(chunks), 1, [&](size_t begin, size_t end, int worker) {
+    Scratch& sc = scratch[static_cast<size_t>(worker)];
+    for (size_t c = begin; c < end; ++c) {
+      const size_t n = static_cast<size_t>(std::min<uint64_t>(chunk, opt.samples - c * chunk));
+
+      // Пакет c генерируется одинаково при любом числе потоков
+      std::mt19937_64 rng(opt.rngSeed * 0x9E3779B97F4A7C15ULL + c);
+      for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < dof; ++j) {
+          const double a = limits ? opt.lowerDeg[j] : -180.0;
+          const double b = limits ? opt.upperDeg[j] :  180.0;
+          sc.thetas[i * dof + j] = std::uniform_real_distribution<double>(a, b)(rng);
+        }
+      }
+
+      FkSimd::computeBatch(chain, sc.thetas.data(), n, sc.tcp, Core::BatchOutput::TcpOnly,
+                           ResultsSoA::Content::Positions, FkSimd::detectIsa(), opt.trig);
+
+      const double* px = sc.tcp.column(ResultsSoA::X, 0);
+      const double* py = sc.tcp.column(ResultsSoA::Y, 0);
+      const double* pz = sc.tcp.column(ResultsSoA::Z, 0);
+      for (size_t i = 0; i < n; ++i) {
+        sc.grid.add(px[i], py[i], pz[i]);
+        sc.lo[0] = std::min(sc.lo[0], px[i]); sc.hi[0] = std::max(sc.hi[0], px[i]);
+        sc.lo[1] = std::min(sc.lo[1], py[i]); sc.hi[1] = std::max(sc.hi[1], py[i]);
+        sc.lo[2] = std::min(sc.lo[2], pz[i]); sc.hi[2] = std::max(sc.hi[2], pz[i]);
+      }
+    }
+  });
+
+  res.minX = res.minY = res.minZ = inf;
+  res.maxX = res.maxY = res.maxZ = -inf;
+  for (const auto& sc : scratch) {
+    res.grid.merge(sc.grid);
+    res.minX = std::min(res.minX, sc.lo[0]); res.maxX = std::max(res.maxX, sc.hi[0]);
+    res.minY = std::min(res.minY, sc.lo[1]); res.maxY = std::max(res.maxY, sc.hi[1]);
+    res.minZ = std::min(res.minZ, sc.lo[2]); res.maxZ = std::max(res.maxZ, sc.hi[2]);
+  }
+
+  res.samples = res.grid.total() + res.grid.outside();
+  res.outside = res.grid.outside();
+  res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return res;
+}
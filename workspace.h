@@ -0,0 +1,88 @@
+#pragma once
+#include "initaldate.h"
+#include "fast_trig.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Разреженная воксельная сетка достижимости: вокселю — число попавших в него TCP.
+// Индекс вокселя (ix,iy,iz) = floor(p / voxelSize); хранятся только занятые.
+// Индекс по оси — в [-2^20, 2^20) (ключ — 21 бит на ось); точки дальше в сетку не попадают.
+class VoxelGrid {
+public:
+  explicit VoxelGrid(double voxelSize = 0.05) : voxel_(voxelSize) {}
+
+  double voxelSize() const { return voxel_; }
+  size_t occupied() const { return cells_.size(); }
+  uint64_t total() const { return total_; }       // точек в сетке
+  uint64_t outside() const { return outside_; }   // отброшенных: вне диапазона индексов или NaN
+
+  // Учесть точку (метры); false — вне сетки (посчитана в outside())
+  bool add(double x, double y, double z);
+
+  // Слить другую сетку того же размера вокселя (сложение счётчиков)
+  void merge(const VoxelGrid& other);
+
+  // Сколько точек в вокселе, содержащем p (0 — недостижимо по выборке или вне сетки)
+  uint32_t countAt(double x, double y, double z) const;
+
+  // Обход занятых вокселей: f(ix, iy, iz, count)
+  template <class F>
+  void forEach(F&& f) const {
+    for (const auto& kv : cells_) {
+      int ix, iy, iz;
+      unpack(kv.first, ix, iy, iz);
+      f(ix, iy, iz, kv.second);
+    }
+  }
+
+  // Центр вокселя по индексу (метры)
+  void center(int ix, int iy, int iz, double& x, double& y, double& z) const {
+    x = (ix + 0.5) * voxel_; y = (iy + 0.5) * voxel_; z = (iz + 0.5) * voxel_;
+  }
+
+private:
+  // По 21 бит со знаком на ось; индексы — только из cellOf (диапазон уже проверен)
+  static bool cellOf(double voxel, double x, double y, double z, int& ix, int& iy, int& iz);
+  static uint64_t pack(int ix, int iy, int iz);
+  static void unpack(uint64_t key, int& ix, int& iy, int& iz);
+
+  double voxel_;
+  uint64_t total_ = 0;
+  uint64_t outside_ = 0;
+  std::unordered_map<uint64_t, uint32_t> cells_;
+};
+
+struct WorkspaceOptions {
+  // Диапазоны theta по суставам (градусы). Пусто — [-180, 180] для всех.
+  // Иначе оба вектора длины dof, конечные, lower <= upper; неверные — отказ (WorkspaceResult::error).
+  std::vector<double> lowerDeg;
+  std::vector<double> upperDeg;
+
+  uint64_t samples   = 1000000;   // всего конфигураций
+  double   voxelSize = 0.05;      // м
+  int      threads   = 0;         // всего исполнителей; 0 — по числу ядер
+  uint64_t rngSeed   = 1;
+  size_t   chunk     = 4096;      // конфигураций за один пакет FK
+
+  // sin/cos в FK: полиномы fast_trig.h заметно быстрее, а 1e-6 на фоне вокселя
+  // в сантиметры не видно. По умолчанию — точный путь, как у остальных расчётов.
+  FastTrig::Accuracy trig = FastTrig::Accuracy::Libm;
+};
+
+struct WorkspaceResult {
+  VoxelGrid grid;
+  uint64_t samples = 0;
+  uint64_t outside = 0;                  // TCP вне диапазона сетки (в grid не попали)
+  double minX = 0, minY = 0, minZ = 0;   // габарит достигнутых TCP
+  double maxX = 0, maxY = 0, maxZ = 0;
+  double seconds = 0.0;
+  std::string error;                     // не пусто — выборка не запускалась (неверные параметры)
+};
+
+// Монте-Карло по рабочей зоне: случайные конфигурации в заданных диапазонах,
+// пакетная FK (FkSimd, только TCP) по всем ядрам через ThreadPool, TCP -> воксели.
+// Результат детерминирован по (rngSeed, chunk) и не зависит от числа потоков.
+WorkspaceResult sampleWorkspace(const Snapshot& chain, const WorkspaceOptions& opt = {});